@@ -0,0 +1,129 @@
+#include "AssetPack.hpp"
+
+#include <cstring>
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: An AssetPack holds every file the game loads in one file, with a table of contents in front, so	 *
+ * start up maps one file instead of opening a dozen. SnakePack builds it.										 *
+ ****************************************************************************************************************/
+AssetPack::AssetPack() : data(nullptr), entries(nullptr), entryCount(0)
+{
+}
+
+/*****************************************************************************************************************
+ *										open()																	 *
+ *****************************************************************************************************************
+ * Input: std::string& file name of the pack, or the bytes of a pack and their size								 *
+ * Output: bool indicating if the bytes hold a pack of this version												 *
+ * Description: Checks the header and every entry of the table of contents: names must be terminated and in		 *
+ * order, since find() searches them by halves, and every asset must lie inside the pack. Bytes passed in must	 *
+ * outlive the pack.																							 *
+ ****************************************************************************************************************/
+bool AssetPack::open(const std::string& filename)
+{
+	return file.open(filename) && open(file.getData(), file.getSize());
+}
+
+bool AssetPack::open(const std::uint8_t* bytes, std::size_t size)
+{
+	data = nullptr;
+	entries = nullptr;
+	entryCount = 0;
+
+	PackHeader header;
+	if (bytes == nullptr || size < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(&header, bytes, sizeof(header));
+	if (header.magic != PACK_MAGIC || header.version != PACK_VERSION || header.size != size ||
+		(size - sizeof(header)) / sizeof(PackEntry) < header.entryCount)
+	{
+		return false;
+	}
+
+	const PackEntry* table = reinterpret_cast<const PackEntry*>(bytes + sizeof(header));
+	for (int i = 0; i < header.entryCount; i++)
+	{
+		const PackEntry& entry = table[i];
+		if (std::memchr(entry.name, '\0', PACK_NAME_SIZE) == nullptr || entry.offset > size || entry.size > size - entry.offset ||
+			(i > 0 && std::strcmp(table[i - 1].name, entry.name) >= 0))
+		{
+			return false;
+		}
+		if (entry.format == PackFormat::Rgba && entry.size != static_cast<std::uint64_t>(entry.width) * entry.height * 4)
+		{
+			return false;
+		}
+	}
+
+	data = bytes;
+	entries = table;
+	entryCount = header.entryCount;
+	return true;
+}
+
+void AssetPack::close()
+{
+	data = nullptr;
+	entries = nullptr;
+	entryCount = 0;
+	file.close();
+}
+
+bool AssetPack::isOpen() const
+{
+	return data != nullptr;
+}
+
+/*****************************************************************************************************************
+ *										find()																	 *
+ *****************************************************************************************************************
+ * Input: std::string& name of the asset, the path it would be loaded from as a loose file						 *
+ * Output: PackEntry* of the asset, nullptr if the pack does not hold it or is not open							 *
+ * Description: Binary search of the table of contents. Safe to call from several threads at once.				 *
+ ****************************************************************************************************************/
+const PackEntry* AssetPack::find(const std::string& name) const
+{
+	int low = 0;
+	int high = entryCount;
+	while (low < high)
+	{
+		int middle = (low + high) / 2;
+		int order = std::strcmp(entries[middle].name, name.c_str());
+		if (order == 0)
+		{
+			return &entries[middle];
+		}
+		if (order < 0)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return nullptr;
+}
+
+/*****************************************************************************************************************
+ *										Getters 																 *
+ *****************************************************************************************************************
+ * Input: PackEntry of this pack / None																			 *
+ * Output: The bytes of the asset, in place in the mapped pack / the number of assets							 *
+ * Description: Generic getter functions.																		 *
+ ****************************************************************************************************************/
+const std::uint8_t* AssetPack::getData(const PackEntry& entry) const
+{
+	return data + entry.offset;
+}
+
+int AssetPack::getEntryCount() const
+{
+	return entryCount;
+}
@@ -0,0 +1,74 @@
+#ifndef ASSETPACK_HPP
+#define ASSETPACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "MappedFile.hpp"
+
+// "SNKP" read as a little endian 32 bit number
+#define PACK_MAGIC 0x504B4E53u
+#define PACK_VERSION 1
+// Pack the game looks for next to the executable, built by SnakePack
+#define PACK_FILE "Media.pack"
+// Longest file name an entry holds, including the terminating zero
+#define PACK_NAME_SIZE 48
+// Every asset starts on a multiple of PACK_ALIGNMENT bytes, so raw pixels can be uploaded straight from the map
+#define PACK_ALIGNMENT 16
+
+namespace PackFormat
+{
+	// File: the bytes of the original file. Rgba: a texture decoded ahead of time to width * height * 4 bytes
+	enum ID { File, Rgba };
+}
+
+// Fixed size header at the start of every pack, followed by entryCount entries sorted by name and then the assets.
+// Fields are stored little endian, so a mapped pack can be read in place on the platforms the game ships on
+struct PackHeader
+{
+	std::uint32_t			magic;
+	std::uint16_t			version;
+	std::uint16_t			entryCount;
+	std::uint64_t			size;
+};
+static_assert(sizeof(PackHeader) == 16, "PackHeader must match the file layout");
+
+// One asset of the table of contents. The name is the path the game loads it by, such as "Media/Fonts/Bauhaus93.ttf"
+struct PackEntry
+{
+	char					name[PACK_NAME_SIZE];
+	std::uint64_t			offset;
+	std::uint64_t			size;
+	std::uint32_t			format;
+	std::uint32_t			width;
+	std::uint32_t			height;
+	std::uint32_t			reserved;
+};
+static_assert(sizeof(PackEntry) == 80, "PackEntry must match the file layout");
+
+// A read only view of a pack. Opening maps the file and checks the table of contents; the assets are never copied,
+// so the pointers handed out stay valid for as long as the pack is open
+class AssetPack
+{
+	public:
+								AssetPack();
+		bool					open(const std::string& filename);
+		bool					open(const std::uint8_t* data, std::size_t size);
+		void					close();
+		bool					isOpen() const;
+		const PackEntry*		find(const std::string& name) const;
+		const std::uint8_t*		getData(const PackEntry& entry) const;
+		int						getEntryCount() const;
+
+	private:
+								AssetPack(const AssetPack&);
+		AssetPack&				operator=(const AssetPack&);
+
+	private:
+		MappedFile				file;
+		const std::uint8_t*		data;
+		const PackEntry*		entries;
+		int						entryCount;
+};
+#endif
@@ -0,0 +1,46 @@
+// Generated by SnakeAtlas from the images under Media/Textures. Do not edit, rebuild the SnakeAtlas project instead
+#ifndef ATLASLAYOUT_HPP
+#define ATLASLAYOUT_HPP
+
+// The atlas texture and its size in pixels
+#define ATLAS_FILE "Media/Textures/Atlas.png"
+#define ATLAS_WIDTH 1024
+#define ATLAS_HEIGHT 304
+
+namespace AtlasRegion
+{
+	enum ID { BoardTiles, TileSet, Head, Torso, Food, Glyphs, Count };
+}
+
+// A region of the atlas in pixels, which are the texture coordinates SFML draws with
+struct AtlasRect
+{
+	int						left;
+	int						top;
+	int						width;
+	int						height;
+};
+
+// Where every region lies in the atlas, in the order of AtlasRegion::ID
+const AtlasRect atlasRegions[AtlasRegion::Count] =
+{
+	{ 0, 0, 512, 256 },		// BoardTiles: Media/Textures/SnakeBoardTiles.png
+	{ 512, 0, 224, 64 },		// TileSet: Media/Textures/Textures.png
+	{ 736, 0, 32, 32 },		// Head: Media/Textures/SnakeHead.png
+	{ 768, 0, 32, 32 },		// Torso: Media/Textures/SnakeTorso.png
+	{ 800, 0, 32, 32 },		// Food: Media/Textures/Vegies.png at 64, 0
+	{ 0, 256, 1024, 48 }		// Glyphs: left empty
+};
+
+// The image every region was taken from whole, so a tile set can find its image in the atlas. Regions cut out of
+// an image or left empty have none
+const char* const atlasFiles[AtlasRegion::Count] =
+{
+	"Media/Textures/SnakeBoardTiles.png",
+	"Media/Textures/Textures.png",
+	"Media/Textures/SnakeHead.png",
+	"Media/Textures/SnakeTorso.png",
+	nullptr,
+	nullptr
+};
+#endif
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+// Widest the atlas may grow. Every graphics card the game runs on takes 1024 pixel textures
+#define ATLAS_MAX_WIDTH 1024
+#define DEFAULT_IMAGE "Media/Textures/Atlas.png"
+#define DEFAULT_HEADER "AtlasLayout.hpp"
+
+/*****************************************************************************************************************
+ *										SnakeAtlas																 *
+ *****************************************************************************************************************
+ * Packs the images the game draws into one atlas texture, so the whole scene is drawn from a single texture,	 *
+ * and writes AtlasLayout.hpp, which tells the game where every region ended up. Runs from the directory that	 *
+ * holds Media/, as the game does; the post build step of the project runs it there after every build, so the	 *
+ * atlas and the header always match the images.																 *
+ *																												 *
+ * Usage: SnakeAtlas [--image Media/Textures/Atlas.png] [--header AtlasLayout.hpp]								 *
+ *																												 *
+ * Regions are placed tallest first on shelves: a region goes on the first shelf that is tall enough and has	 *
+ * room left, or opens a new shelf under the others. The game draws with nearest filtering at whole pixels, so	 *
+ * the regions need no gap between them.																		 *
+ ****************************************************************************************************************/
+
+namespace
+{
+	// A region of the atlas. Without a file the region is left empty for the game to fill, without a size the whole
+	// file is taken
+	struct Source
+	{
+		const char*		name;
+		const char*		filename;
+		int				left;
+		int				top;
+		int				width;
+		int				height;
+	};
+
+	// In the order of AtlasRegion::ID. The glyph region is filled by the HUD with the glyphs of its font at start up
+	const Source sources[] =
+	{
+		{ "BoardTiles", "Media/Textures/SnakeBoardTiles.png", 0, 0, 0, 0 },
+		{ "TileSet", "Media/Textures/Textures.png", 0, 0, 0, 0 },
+		{ "Head", "Media/Textures/SnakeHead.png", 0, 0, 0, 0 },
+		{ "Torso", "Media/Textures/SnakeTorso.png", 0, 0, 0, 0 },
+		{ "Food", "Media/Textures/Vegies.png", 64, 0, 32, 32 },
+		{ "Glyphs", nullptr, 0, 0, ATLAS_MAX_WIDTH, 48 }
+	};
+	const int sourceCount = static_cast<int>(sizeof(sources) / sizeof(sources[0]));
+
+	struct Shelf
+	{
+		int				top;
+		int				height;
+		int				used;
+	};
+
+	// Places every region and returns the size of the atlas, or a width of 0 if a region is wider than the atlas
+	sf::Vector2i pack(const std::vector<sf::IntRect>& sizes, std::vector<sf::IntRect>& placed)
+	{
+		std::vector<int> order(sizes.size());
+		for (std::size_t i = 0; i < order.size(); i++)
+		{
+			order[i] = static_cast<int>(i);
+		}
+		std::stable_sort(order.begin(), order.end(), [&sizes](int a, int b) { return sizes[a].height > sizes[b].height; });
+
+		std::vector<Shelf> shelves;
+		sf::Vector2i size(0, 0);
+		placed = sizes;
+		for (int index : order)
+		{
+			sf::IntRect& rect = placed[index];
+			if (rect.width > ATLAS_MAX_WIDTH)
+			{
+				return sf::Vector2i(0, 0);
+			}
+
+			Shelf* shelf = nullptr;
+			for (Shelf& candidate : shelves)
+			{
+				if (candidate.height >= rect.height && ATLAS_MAX_WIDTH - candidate.used >= rect.width)
+				{
+					shelf = &candidate;
+					break;
+				}
+			}
+			if (!shelf)
+			{
+				shelves.push_back({ size.y, rect.height, 0 });
+				size.y += rect.height;
+				shelf = &shelves.back();
+			}
+
+			rect.left = shelf->used;
+			rect.top = shelf->top;
+			shelf->used += rect.width;
+			size.x = std::max(size.x, shelf->used);
+		}
+		return size;
+	}
+
+	bool writeHeader(const std::string& filename, const std::string& image, sf::Vector2i size, const std::vector<sf::IntRect>& placed)
+	{
+		std::ofstream file(filename);
+		file << "// Generated by SnakeAtlas from the images under Media/Textures. Do not edit, rebuild the SnakeAtlas project instead\n"
+			<< "#ifndef ATLASLAYOUT_HPP\n#define ATLASLAYOUT_HPP\n\n"
+			<< "// The atlas texture and its size in pixels\n"
+			<< "#define ATLAS_FILE \"" << image << "\"\n"
+			<< "#define ATLAS_WIDTH " << size.x << "\n"
+			<< "#define ATLAS_HEIGHT " << size.y << "\n\n"
+			<< "namespace AtlasRegion\n{\n\tenum ID { ";
+		for (int i = 0; i < sourceCount; i++)
+		{
+			file << sources[i].name << ", ";
+		}
+		file << "Count };\n}\n\n"
+			<< "// A region of the atlas in pixels, which are the texture coordinates SFML draws with\n"
+			<< "struct AtlasRect\n{\n\tint\t\t\t\t\t\tleft;\n\tint\t\t\t\t\t\ttop;\n\tint\t\t\t\t\t\twidth;\n\tint\t\t\t\t\t\theight;\n};\n\n"
+			<< "// Where every region lies in the atlas, in the order of AtlasRegion::ID\n"
+			<< "const AtlasRect atlasRegions[AtlasRegion::Count] =\n{\n";
+		for (int i = 0; i < sourceCount; i++)
+		{
+			const sf::IntRect& rect = placed[i];
+			file << "\t{ " << rect.left << ", " << rect.top << ", " << rect.width << ", " << rect.height << " }" << (i + 1 < sourceCount ? "," : "")
+				<< "\t\t// " << sources[i].name << ": ";
+			if (sources[i].filename == nullptr)
+			{
+				file << "left empty\n";
+			}
+			else if (sources[i].width == 0)
+			{
+				file << sources[i].filename << '\n';
+			}
+			else
+			{
+				file << sources[i].filename << " at " << sources[i].left << ", " << sources[i].top << '\n';
+			}
+		}
+		file << "};\n\n"
+			<< "// The image every region was taken from whole, so a tile set can find its image in the atlas. Regions cut out of\n"
+			<< "// an image or left empty have none\n"
+			<< "const char* const atlasFiles[AtlasRegion::Count] =\n{\n";
+		for (int i = 0; i < sourceCount; i++)
+		{
+			bool whole = sources[i].filename != nullptr && sources[i].width == 0;
+			file << '\t' << (whole ? "\"" + std::string(sources[i].filename) + "\"" : std::string("nullptr")) << (i + 1 < sourceCount ? ",\n" : "\n");
+		}
+		file << "};\n#endif\n";
+		return static_cast<bool>(file);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string imageFile = DEFAULT_IMAGE;
+	std::string headerFile = DEFAULT_HEADER;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--image" && i + 1 < argc)
+		{
+			imageFile = argv[++i];
+		}
+		else if (option == "--header" && i + 1 < argc)
+		{
+			headerFile = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Usage: SnakeAtlas [--image file.png] [--header file.hpp]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<sf::Image> images(sourceCount);
+	std::vector<sf::IntRect> sizes(sourceCount);
+	for (int i = 0; i < sourceCount; i++)
+	{
+		const Source& source = sources[i];
+		if (source.filename != nullptr && !images[i].loadFromFile(source.filename))
+		{
+			std::cerr << "Could not read " << source.filename << std::endl;
+			return 1;
+		}
+		bool whole = source.filename != nullptr && source.width == 0;
+		sizes[i] = sf::IntRect(source.left, source.top, whole ? static_cast<int>(images[i].getSize().x) : source.width,
+			whole ? static_cast<int>(images[i].getSize().y) : source.height);
+	}
+
+	std::vector<sf::IntRect> placed;
+	sf::Vector2i size = pack(sizes, placed);
+	if (size.x == 0)
+	{
+		std::cerr << "A region is wider than " << ATLAS_MAX_WIDTH << " pixels" << std::endl;
+		return 1;
+	}
+
+	sf::Image atlas;
+	atlas.create(size.x, size.y, sf::Color::Transparent);
+	for (int i = 0; i < sourceCount; i++)
+	{
+		if (sources[i].filename != nullptr)
+		{
+			atlas.copy(images[i], placed[i].left, placed[i].top, sizes[i]);
+		}
+	}
+
+	if (!atlas.saveToFile(imageFile) || !writeHeader(headerFile, imageFile, size, placed))
+	{
+		std::cerr << "Could not write " << imageFile << " and " << headerFile << std::endl;
+		return 1;
+	}
+	std::cout << imageFile << ": " << sourceCount << " regions, " << size.x << "x" << size.y << "\n";
+	return 0;
+}
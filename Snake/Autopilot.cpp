@@ -0,0 +1,283 @@
+#include "Autopilot.hpp"
+
+#include <cstring>
+
+// Returned by search() and the move checks when the goal cannot be reached
+#define UNREACHABLE -1
+// Board sizes the snake may circle without eating before it takes the food even when that is unsafe
+#define MAX_STALL_LAPS 2
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: The autopilot drives the snake with breadth first searches over the board. Every buffer a search *
+ * needs (visit marks, queue, parents, distances and the path) is a fixed array sized for the largest board, so  *
+ * a decision never allocates. Visit marks carry a generation number, so starting a search clears nothing.		 *
+ ****************************************************************************************************************/
+AutopilotPolicy::AutopilotPolicy() : width(0), height(0), lastLength(0), stalledTicks(0), visitMark(0)
+{
+	std::memset(visited, 0, sizeof(visited));
+}
+
+/*****************************************************************************************************************
+ *										decide()																 *
+ *****************************************************************************************************************
+ * Input: GameCore to drive																						 *
+ * Output: Direction for the next tick																			 *
+ * Description: Takes the shortest path to the food when, after eating it, the head could still reach the tail.  *
+ * Chasing the tail is always a way out, so the snake never commits to a pocket it cannot leave. Otherwise it    *
+ * makes the safe move that keeps the tail reachable along the longest route, which stalls until the food is     *
+ * safe to take. When no move keeps the tail in reach, it moves into the largest free area.						 *
+ * Stalling can turn into an endless loop when the snake and the food settle into a repeating pattern, so after *
+ * MAX_STALL_LAPS board sizes of ticks without eating the food is taken regardless.								 *
+ ****************************************************************************************************************/
+Direction AutopilotPolicy::decide(const GameCore& core)
+{
+	width = core.getBoardWidth();
+	height = core.getBoardHeight();
+	int head = toIndex(core.getBody().front());
+	int food = toIndex(core.getFood());
+
+	stalledTicks = (core.getLength() == lastLength) ? stalledTicks + 1 : 0;
+	lastLength = core.getLength();
+
+	core.getBlocked(scratch);
+	if (search(scratch, head, food) != UNREACHABLE)
+	{
+		int pathLength = tracePath(food);
+		if (stalledTicks > MAX_STALL_LAPS * width * height || tailReachableAfterPath(core, pathLength))
+		{
+			return directionTo(head, path[0]);
+		}
+	}
+
+	Direction best = core.getDirection();
+	int bestDistance = UNREACHABLE;
+	for (Direction direction : { Down, Left, Right, Up })
+	{
+		int tailDistance = tailDistanceAfterMove(core, direction);
+		if (tailDistance > bestDistance)
+		{
+			best = direction;
+			bestDistance = tailDistance;
+		}
+	}
+	if (bestDistance != UNREACHABLE)
+	{
+		return best;
+	}
+
+	int bestArea = UNREACHABLE;
+	for (Direction direction : { Down, Left, Right, Up })
+	{
+		int area = freeAreaAfterMove(core, direction);
+		if (area > bestArea)
+		{
+			best = direction;
+			bestArea = area;
+		}
+	}
+	return best;
+}
+
+/*****************************************************************************************************************
+ *										search()																 *
+ *****************************************************************************************************************
+ * Input: OccupancyGrid of blocked cells, int start cell and int goal cell (UNREACHABLE to flood the area)		 *
+ * Output: int distance to the goal, UNREACHABLE if there is no path; the number of reachable cells when no goal *
+ * is given																										 *
+ * Description: Breadth first search from the start over cells that are not blocked. The goal may itself be      *
+ * blocked (the tail), the start is never tested. Parents and distances are kept for tracePath().				 *
+ ****************************************************************************************************************/
+int AutopilotPolicy::search(const OccupancyGrid& blocked, int start, int goal)
+{
+	visitMark++;
+	int first = 0;
+	int last = 0;
+	visited[start] = visitMark;
+	distance[start] = 0;
+	queue[last++] = static_cast<std::uint16_t>(start);
+
+	while (first < last)
+	{
+		int cell = queue[first++];
+		if (cell == goal)
+		{
+			return distance[cell];
+		}
+
+		int x = cell % width;
+		int y = cell / width;
+		int neighbours[4];
+		int count = 0;
+		if (x > 0)			neighbours[count++] = cell - 1;
+		if (x < width - 1)	neighbours[count++] = cell + 1;
+		if (y > 0)			neighbours[count++] = cell - width;
+		if (y < height - 1)	neighbours[count++] = cell + width;
+
+		for (int i = 0; i < count; i++)
+		{
+			int next = neighbours[i];
+			if (visited[next] == visitMark || (next != goal && blocked.test(next % width, next / width)))
+			{
+				continue;
+			}
+			visited[next] = visitMark;
+			parent[next] = static_cast<std::uint16_t>(cell);
+			distance[next] = static_cast<std::uint16_t>(distance[cell] + 1);
+			queue[last++] = static_cast<std::uint16_t>(next);
+		}
+	}
+	return (goal == UNREACHABLE) ? last : UNREACHABLE;
+}
+
+/*****************************************************************************************************************
+ *										tracePath()																 *
+ *****************************************************************************************************************
+ * Input: int goal of the last successful search()																 *
+ * Output: int number of steps on the path																		 *
+ * Description: Follows the parents back from the goal and stores the path in walking order, so path[0] is the  *
+ * first step and the goal is last.																				 *
+ ****************************************************************************************************************/
+int AutopilotPolicy::tracePath(int goal)
+{
+	int pathLength = distance[goal];
+	int cell = goal;
+	for (int i = pathLength - 1; i >= 0; i--)
+	{
+		path[i] = static_cast<std::uint16_t>(cell);
+		cell = parent[cell];
+	}
+	return pathLength;
+}
+
+/*****************************************************************************************************************
+ *										tailReachableAfterPath()												 *
+ *****************************************************************************************************************
+ * Input: GameCore being driven, int length of the path to the food stored in path								 *
+ * Output: bool indicating if the head could reach the tail after walking the path and eating					 *
+ * Description: Builds the body the snake would have after eating, between the walls of the board: the path		 *
+ * walked backwards from the food, followed by as much of the current body as still fits into the grown length.	 *
+ ****************************************************************************************************************/
+bool AutopilotPolicy::tailReachableAfterPath(const GameCore& core, int pathLength)
+{
+	const SnakeBody& body = core.getBody();
+	int grownLength = body.size() + 1;
+
+	// Eating the last free cell wins the game, there is nothing left to reach
+	if (grownLength >= width * height)
+	{
+		return true;
+	}
+
+	scratch.resize(width, height);
+	scratch.merge(core.getWalls());
+	int tail;
+	if (pathLength >= grownLength)
+	{
+		for (int i = pathLength - grownLength; i < pathLength; i++)
+		{
+			scratch.set(path[i] % width, path[i] / width);
+		}
+		tail = path[pathLength - grownLength];
+	}
+	else
+	{
+		for (int i = 0; i < pathLength; i++)
+		{
+			scratch.set(path[i] % width, path[i] / width);
+		}
+		int kept = grownLength - pathLength;
+		for (int i = 0; i < kept; i++)
+		{
+			scratch.set(body[i].x, body[i].y);
+		}
+		tail = toIndex(body[kept - 1]);
+	}
+
+	return search(scratch, path[pathLength - 1], tail) != UNREACHABLE;
+}
+
+/*****************************************************************************************************************
+ *										tailDistanceAfterMove()													 *
+ *****************************************************************************************************************
+ * Input: GameCore being driven, Direction of the move															 *
+ * Output: int length of the shortest route from the new head to the new tail, UNREACHABLE if the move is not    *
+ * safe or the tail cannot be reached																			 *
+ * Description: Moves the snake one cell on a scratch grid, growing it if the move eats, and searches for the    *
+ * tail.																										 *
+ ****************************************************************************************************************/
+int AutopilotPolicy::tailDistanceAfterMove(const GameCore& core, Direction direction)
+{
+	if (!isSafeMove(core, direction))
+	{
+		return UNREACHABLE;
+	}
+
+	const SnakeBody& body = core.getBody();
+	int head = toIndex(body.front());
+	int next = head + ((direction == Right) - (direction == Left)) + ((direction == Down) - (direction == Up)) * width;
+	bool eats = (next == toIndex(core.getFood()));
+
+	core.getBlocked(scratch);
+	int tail = toIndex(body.back());
+	if (!eats)
+	{
+		scratch.reset(body.back().x, body.back().y);
+		tail = toIndex(body[body.size() - 2]);
+	}
+	scratch.set(next % width, next / width);
+
+	return search(scratch, next, tail);
+}
+
+/*****************************************************************************************************************
+ *										freeAreaAfterMove()														 *
+ *****************************************************************************************************************
+ * Input: GameCore being driven, Direction of the move															 *
+ * Output: int number of cells reachable after the move, UNREACHABLE if the move is not safe					 *
+ * Description: Last resort when no move keeps the tail in reach: the bigger the area, the longer the snake      *
+ * survives and the more likely the tail frees a way out.														 *
+ ****************************************************************************************************************/
+int AutopilotPolicy::freeAreaAfterMove(const GameCore& core, Direction direction)
+{
+	if (!isSafeMove(core, direction))
+	{
+		return UNREACHABLE;
+	}
+
+	int head = toIndex(core.getBody().front());
+	int next = head + ((direction == Right) - (direction == Left)) + ((direction == Down) - (direction == Up)) * width;
+	core.getBlocked(scratch);
+	scratch.reset(core.getBody().back().x, core.getBody().back().y);
+	scratch.set(next % width, next / width);
+
+	return search(scratch, next, UNREACHABLE);
+}
+
+/*****************************************************************************************************************
+ *										directionTo() / toIndex()												 *
+ *****************************************************************************************************************
+ * Input: Two neighbouring cell indices / a Cell																 *
+ * Output: Direction from the first cell to the second / the index of the cell									 *
+ * Description: Conversions between board cells, cell indices (y * width + x) and directions.					 *
+ ****************************************************************************************************************/
+Direction AutopilotPolicy::directionTo(int from, int to) const
+{
+	if (to == from + 1)
+	{
+		return Right;
+	}
+	if (to == from - 1)
+	{
+		return Left;
+	}
+	return (to > from) ? Down : Up;
+}
+
+int AutopilotPolicy::toIndex(Cell cell) const
+{
+	return cell.y * width + cell.x;
+}
@@ -0,0 +1,37 @@
+#ifndef AUTOPILOT_HPP
+#define AUTOPILOT_HPP
+
+#include <cstdint>
+
+#include "GameCore.hpp"
+#include "Policy.hpp"
+
+class AutopilotPolicy : public Policy
+{
+	public:
+								AutopilotPolicy();
+		Direction				decide(const GameCore& core);
+
+	private:
+		int						search(const OccupancyGrid& blocked, int start, int goal);
+		int						tracePath(int goal);
+		bool					tailReachableAfterPath(const GameCore& core, int pathLength);
+		int						tailDistanceAfterMove(const GameCore& core, Direction direction);
+		int						freeAreaAfterMove(const GameCore& core, Direction direction);
+		Direction				directionTo(int from, int to) const;
+		int						toIndex(Cell cell) const;
+
+	private:
+		int						width;
+		int						height;
+		int						lastLength;
+		int						stalledTicks;
+		OccupancyGrid			scratch;
+		std::uint32_t			visitMark;
+		std::uint32_t			visited[MAX_BOARD_CELLS];
+		std::uint16_t			queue[MAX_BOARD_CELLS];
+		std::uint16_t			parent[MAX_BOARD_CELLS];
+		std::uint16_t			distance[MAX_BOARD_CELLS];
+		std::uint16_t			path[MAX_BOARD_CELLS];
+};
+#endif
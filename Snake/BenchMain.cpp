@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "GameCore.hpp"
+#include "Hamilton.hpp"
+#include "ResourceHolder.hpp"
+#include "Hud.hpp"
+#include "Snake.hpp"
+
+// Samples taken per benchmark, and the operations timed together in one sample
+#define DEFAULT_SAMPLES 2000
+#define BATCH_OPS 64
+// Empty timed regions measured to find the cost of reading the clock
+#define TIMER_CALIBRATION_SAMPLES 10000
+#define DEFAULT_OUTPUT "SnakeBench.json"
+
+/*****************************************************************************************************************
+ *										SnakeBench																 *
+ *****************************************************************************************************************
+ * Micro benchmarks of the functions the game runs every tick, each timed in isolation on real game positions	 *
+ * and written out as JSON so two builds can be compared.														 *
+ *																												 *
+ * Usage: SnakeBench [--boards 32x28,16x16] [--lengths 3,50,200,500,800] [--samples N] [--output file|-]		 *
+ *																												 *
+ * For every board and snake length, the hamilton policy plays a game until the snake reaches that length, and *
+ * the core functions are timed on that position:																 *
+ *   GameCore::collidesWithSelf   the body test for the cells around the head									 *
+ *   GameCore::step               a tick that moves the snake without eating (Snake::moveForward plus the wall,   *
+ *                                body and food tests, Snake::collidesWithFood)									 *
+ *   GameCore::step eating        the tick that eats the food: the growth (Snake::increaseSize) and the new food  *
+ *   OccupancyGrid::findFree      drawing the food cell (Food::randomizeLocation) from the free cells			 *
+ * Hud::setValue and the ResourceHolder lookups do not depend on the board and are timed once. They			 *
+ * need the Media folder, so SnakeBench runs from the same directory as the game.								 *
+ *																												 *
+ * Every sample times BATCH_OPS operations, except the eating tick which has to start from the same position	 *
+ * each time and is timed one operation at a time, less the measured cost of reading the clock. The report		 *
+ * gives the mean and the 50th, 90th and 99th percentile of the samples in ns/op, and the heap allocations per	 *
+ * operation, counted by replacing the global operator new. The report goes to SnakeBench.json unless --output  *
+ * names another file, or - for the standard output.															 *
+ ****************************************************************************************************************/
+
+namespace
+{
+	std::atomic<long long> allocations(0);
+	volatile int sink;
+
+	struct Options
+	{
+		std::vector<std::pair<int, int>>	boards;
+		std::vector<int>					lengths;
+		int									samples;
+		std::string							output;
+	};
+
+	struct Result
+	{
+		std::string			name;
+		int					width;
+		int					height;
+		int					length;
+		long long			ops;
+		double				mean;
+		double				p50;
+		double				p90;
+		double				p99;
+		double				allocationsPerOp;
+	};
+
+	double now()
+	{
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Turns the ns/op of every sample into the summary written to the report
+	Result summarize(const std::string& name, std::vector<double>& samples, long long ops, long long allocated)
+	{
+		std::sort(samples.begin(), samples.end());
+		double sum = 0.0;
+		for (double sample : samples)
+		{
+			sum += sample;
+		}
+		auto percentile = [&samples](double p) { return samples[static_cast<std::size_t>(p * (samples.size() - 1))]; };
+
+		Result result;
+		result.name = name;
+		result.width = 0;
+		result.height = 0;
+		result.length = 0;
+		result.ops = ops;
+		result.mean = sum / samples.size();
+		result.p50 = percentile(0.50);
+		result.p90 = percentile(0.90);
+		result.p99 = percentile(0.99);
+		result.allocationsPerOp = static_cast<double>(allocated) / ops;
+		return result;
+	}
+
+	// Times samples of BATCH_OPS calls of operation(i). setup() runs before each sample, outside the timing
+	template <typename Setup, typename Operation>
+	Result timeBatches(const std::string& name, int samples, Setup setup, Operation operation)
+	{
+		std::vector<double> perOp;
+		perOp.reserve(static_cast<std::size_t>(samples));
+		long long allocated = 0;
+		for (int sample = 0; sample < samples; sample++)
+		{
+			int ops = setup();
+			long long allocationsBefore = allocations.load(std::memory_order_relaxed);
+			double start = now();
+			for (int i = 0; i < ops; i++)
+			{
+				operation(i);
+			}
+			double elapsed = now() - start;
+			allocated += allocations.load(std::memory_order_relaxed) - allocationsBefore;
+			perOp.push_back(elapsed / ops);
+		}
+		return summarize(name, perOp, static_cast<long long>(samples) * setup(), allocated);
+	}
+
+	double timerOverhead()
+	{
+		std::vector<double> samples;
+		samples.reserve(TIMER_CALIBRATION_SAMPLES);
+		for (int i = 0; i < TIMER_CALIBRATION_SAMPLES; i++)
+		{
+			double start = now();
+			samples.push_back(now() - start);
+		}
+		std::sort(samples.begin(), samples.end());
+		return samples[samples.size() / 2];
+	}
+
+	bool parseList(const std::string& text, std::vector<std::string>& items)
+	{
+		std::stringstream stream(text);
+		std::string item;
+		while (std::getline(stream, item, ','))
+		{
+			items.push_back(item);
+		}
+		return !items.empty();
+	}
+
+	bool parseOptions(int argc, char* argv[], Options& options)
+	{
+		options.samples = DEFAULT_SAMPLES;
+		options.output = DEFAULT_OUTPUT;
+		std::string boards = "32x28,16x16";
+		std::string lengths = "3,50,200,500,800";
+
+		for (int i = 1; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			if (i + 1 >= argc)
+			{
+				std::cerr << "Missing value for " << argument << std::endl;
+				return false;
+			}
+			std::string value = argv[++i];
+
+			if (argument == "--boards")			boards = value;
+			else if (argument == "--lengths")	lengths = value;
+			else if (argument == "--samples")	options.samples = std::atoi(value.c_str());
+			else if (argument == "--output")	options.output = value;
+			else
+			{
+				std::cerr << "Unknown option " << argument << std::endl;
+				return false;
+			}
+		}
+
+		std::vector<std::string> items;
+		parseList(boards, items);
+		for (const std::string& item : items)
+		{
+			int width = 0;
+			int height = 0;
+			std::size_t separator = item.find('x');
+			if (separator != std::string::npos)
+			{
+				width = std::atoi(item.substr(0, separator).c_str());
+				height = std::atoi(item.substr(separator + 1).c_str());
+			}
+			if (!isPlayableBoard(width, height))
+			{
+				std::cerr << "Bad board " << item << ", boards are WxH, at least " << MIN_BOARD_WIDTH << " wide with at most " << MAX_BOARD_CELLS << " cells" << std::endl;
+				return false;
+			}
+			options.boards.push_back(std::make_pair(width, height));
+		}
+
+		items.clear();
+		parseList(lengths, items);
+		for (const std::string& item : items)
+		{
+			options.lengths.push_back(std::atoi(item.c_str()));
+		}
+		if (options.samples < 1)
+		{
+			options.samples = 1;
+		}
+		return true;
+	}
+
+	// Times the core functions on one board at every requested length the hamilton policy reaches
+	void benchBoard(int width, int height, const Options& options, double overhead, std::vector<Result>& results)
+	{
+		for (int length : options.lengths)
+		{
+			// Play until the tick that grows the snake to the requested length. The position before that tick
+			// is the start of the eating benchmark, the position after it starts the others
+			GameCore core(width, height, 1);
+			HamiltonPolicy policy;
+			std::unique_ptr<GameSnapshot> beforeEating(new GameSnapshot());
+			std::unique_ptr<GameSnapshot> afterEating(new GameSnapshot());
+			Direction eatingMove = core.getDirection();
+			bool reached = (length == core.getLength());
+			bool ate = false;
+			core.snapshot(*afterEating);
+			while (!reached && !core.isGameOver())
+			{
+				core.snapshot(*beforeEating);
+				eatingMove = policy.decide(core);
+				int events = core.step(eatingMove);
+				if ((events & GameEvent::AteFood) && core.getLength() == length && !core.isGameOver())
+				{
+					core.snapshot(*afterEating);
+					reached = true;
+					ate = true;
+				}
+			}
+			if (!reached)
+			{
+				continue;
+			}
+
+			// The moves after the length is reached, up to the next food
+			core.restore(*afterEating);
+			std::vector<Direction> moves;
+			while (static_cast<int>(moves.size()) < BATCH_OPS)
+			{
+				Direction move = policy.decide(core);
+				if (core.step(move) != GameEvent::None)
+				{
+					break;
+				}
+				moves.push_back(move);
+			}
+
+			std::vector<Result> board;
+			core.restore(*afterEating);
+			Cell head = core.getBody().front();
+			const int probes[4][2] = { { head.x, head.y + 1 }, { head.x - 1, head.y }, { head.x + 1, head.y }, { head.x, head.y - 1 } };
+			int probeCount = 0;
+			int probeCells[4][2];
+			for (const int* probe : probes)
+			{
+				if (!core.collidesWithWall(probe[0], probe[1]))
+				{
+					probeCells[probeCount][0] = probe[0];
+					probeCells[probeCount][1] = probe[1];
+					probeCount++;
+				}
+			}
+			board.push_back(timeBatches("GameCore::collidesWithSelf", options.samples, [] { return BATCH_OPS; },
+				[&core, &probeCells, probeCount](int i) { sink = sink + core.collidesWithSelf(probeCells[i % probeCount][0], probeCells[i % probeCount][1]); }));
+
+			if (!moves.empty())
+			{
+				board.push_back(timeBatches("GameCore::step", options.samples,
+					[&core, &afterEating, &moves] { core.restore(*afterEating); return static_cast<int>(moves.size()); },
+					[&core, &moves](int i) { sink = sink + core.step(moves[static_cast<std::size_t>(i)]); }));
+			}
+
+			// The eating tick changes the position, so it is timed one operation at a time from the same start
+			std::vector<double> perOp;
+			perOp.reserve(static_cast<std::size_t>(options.samples));
+			long long allocated = 0;
+			for (int sample = 0; ate && sample < options.samples; sample++)
+			{
+				core.restore(*beforeEating);
+				long long allocationsBefore = allocations.load(std::memory_order_relaxed);
+				double begin = now();
+				sink = sink + core.step(eatingMove);
+				double elapsed = now() - begin;
+				allocated += allocations.load(std::memory_order_relaxed) - allocationsBefore;
+				perOp.push_back(std::max(0.0, elapsed - overhead));
+			}
+			if (ate)
+			{
+				board.push_back(summarize("GameCore::step eating", perOp, options.samples, allocated));
+			}
+
+			core.restore(*afterEating);
+			OccupancyGrid excluded;
+			excluded.resize(width, height);
+			std::uint32_t freeCells = static_cast<std::uint32_t>(core.getOccupied().countFree(excluded));
+			if (freeCells > 0)
+			{
+				Random random(1);
+				board.push_back(timeBatches("OccupancyGrid::findFree", options.samples, [] { return BATCH_OPS; },
+					[&core, &excluded, &random, freeCells](int) { sink = sink + core.getOccupied().findFree(static_cast<int>(random.nextBelow(freeCells)), excluded); }));
+			}
+
+			for (Result& result : board)
+			{
+				result.width = width;
+				result.height = height;
+				result.length = length;
+				results.push_back(result);
+			}
+		}
+	}
+
+	// Times the SFML side: the score text and the resource lookups
+	void benchResources(const Options& options, std::vector<Result>& results)
+	{
+		ResourceHolder resourceHolder;
+		sf::Image image;
+		image.create(BODY_DIMENSIONS, BODY_DIMENSIONS, sf::Color::White);
+		resourceHolder.loadTextures(Textures::ID::Head, image);
+		sf::Image atlas;
+		atlas.create(ATLAS_WIDTH, ATLAS_HEIGHT, sf::Color::Transparent);
+		resourceHolder.loadTextures(Textures::ID::Atlas, atlas);
+		resourceHolder.loadSoundBuffers(SoundBuffers::ID::Munch, "Media/SoundBuffers/Munch.wav");
+		resourceHolder.loadFonts(Fonts::ID::Bauhaus, "Media/Fonts/Bauhaus93.ttf");
+
+		Hud hud(resourceHolder.getTextures(Textures::ID::Atlas), resourceHolder.getFont(Fonts::ID::Bauhaus));
+		int score = 0;
+		results.push_back(timeBatches("Hud::setValue", options.samples, [] { return BATCH_OPS; },
+			[&hud, &score](int) { hud.setValue(Readout::ID::Score, ++score); }));
+		results.push_back(timeBatches("Hud::setValue unchanged", options.samples, [] { return BATCH_OPS; },
+			[&hud, &score](int) { hud.setValue(Readout::ID::Score, score); }));
+
+		results.push_back(timeBatches("ResourceHolder::getTextures", options.samples, [] { return BATCH_OPS; },
+			[&resourceHolder](int i) { sink = sink + static_cast<int>(resourceHolder.getTextures((i & 1) ? Textures::ID::Head : Textures::ID::Atlas).getSize().x); }));
+		results.push_back(timeBatches("ResourceHolder::getSoundBuffers", options.samples, [] { return BATCH_OPS; },
+			[&resourceHolder](int) { sink = sink + static_cast<int>(reinterpret_cast<std::uintptr_t>(&resourceHolder.getSoundBuffers(SoundBuffers::ID::Munch))); }));
+		results.push_back(timeBatches("ResourceHolder::getFont", options.samples, [] { return BATCH_OPS; },
+			[&resourceHolder](int) { sink = sink + static_cast<int>(reinterpret_cast<std::uintptr_t>(&resourceHolder.getFont(Fonts::ID::Bauhaus))); }));
+	}
+
+	void writeReport(std::ostream& out, const Options& options, double overhead, const std::vector<Result>& results)
+	{
+		out << "{\n  \"benchmark\": \"SnakeBench\",\n  \"samples\": " << options.samples << ",\n  \"batchOps\": " << BATCH_OPS
+			<< ",\n  \"timerOverheadNs\": " << overhead << ",\n  \"results\": [\n";
+		for (std::size_t i = 0; i < results.size(); i++)
+		{
+			const Result& result = results[i];
+			out << "    { \"name\": \"" << result.name << "\"";
+			if (result.width > 0)
+			{
+				out << ", \"board\": \"" << result.width << "x" << result.height << "\", \"length\": " << result.length;
+			}
+			out << ", \"ops\": " << result.ops << ", \"nsPerOp\": " << result.mean << ", \"p50\": " << result.p50
+				<< ", \"p90\": " << result.p90 << ", \"p99\": " << result.p99 << ", \"allocationsPerOp\": " << result.allocationsPerOp
+				<< " }" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+		out << "  ]\n}\n";
+	}
+}
+
+// Every heap allocation of the process goes through these, so the benchmarks can count them
+void* operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+	{
+		std::cerr << "Usage: SnakeBench [--boards 32x28,16x16] [--lengths 3,50,200,500,800] [--samples N] [--output file|-]" << std::endl;
+		return 1;
+	}
+
+	double overhead = timerOverhead();
+	std::vector<Result> results;
+	for (const std::pair<int, int>& board : options.boards)
+	{
+		benchBoard(board.first, board.second, options, overhead, results);
+	}
+	benchResources(options, results);
+
+	if (options.output == "-")
+	{
+		writeReport(std::cout, options, overhead, results);
+		return 0;
+	}
+	std::ofstream file(options.output);
+	writeReport(file, options, overhead, results);
+	if (!file)
+	{
+		std::cerr << "Could not write " << options.output << std::endl;
+		return 1;
+	}
+	std::cout << results.size() << " results written to " << options.output << std::endl;
+	return 0;
+}
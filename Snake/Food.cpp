@@ -1,103 +1,61 @@
 #include "Food.hpp"
 
+#include "FrameProfiler.hpp"
+
 /*****************************************************************************************************************
  *										Constructor   															 *
  *****************************************************************************************************************
- * Input: Instance of a RenderWindow and ResourceHolder															 *
+ * Input: Instance of a GameCore and ResourceHolder																 *
  * Output: None																									 *
- * Description: The constructor initializes the window, food sprite's texture, and biteSound's sound buffer.     *
- * It also sets up the first food location by generating its location on the game board and settings its position*
- * It is the respoinsibility of the programmer to pass a RenderWindow and ResourceHolder instance.               *
+ * Description: The constructor initializes biteSound's sound buffer. The Food class is the view of the food     *
+ * held by the GameCore, which decides where the food is placed.												 *
+ * It is the respoinsibility of the programmer to pass a GameCore and ResourceHolder instance.                   *
  ****************************************************************************************************************/
 
-Food::Food(sf::RenderWindow& window, ResourceHolder& resourceHolder) : window(window), food(resourceHolder.getTextures(Textures::ID::Veggies)),
+Food::Food(const GameCore& core, ResourceHolder& resourceHolder) : core(core),
 biteSound(resourceHolder.getSoundBuffers(SoundBuffers::ID::Munch))
 {
-	foodLocation = randomizeLocation();
-	// The TileSet the food is located on are based on these coordinates
-	food.setTextureRect(sf::IntRect(2 * 32, 0 * 32, 32, 32));
-	food.setPosition(foodLocation);
-}
-
-/*****************************************************************************************************************
- *										randomizeLocation()														 *
- *****************************************************************************************************************
- * Input: None																									 *
- * Output: sf::Vector2f																							 *
- * Description: The purpose of this function is to generate the exact x and y location for the next apple in     *
- * game. It uses the rand() function to generate a random number from 0 to the window size of and x and y. The	 *
- * coordinates generated will adapt to the window size, therefore will adjust accordingly if the user wishes to  *
- * change window heights or widths.																				 *
- ****************************************************************************************************************/
-sf::Vector2f Food::randomizeLocation()
-{
-	sf::Vector2f randomLocation;
-
-	/* Get random locations for both x and y for the food's next location. It relies on
-	   the game's window dimensions, therefore is adaptable to any window size. */
-	randomLocation.x = (rand() % window.getSize().x) / 32;
-	randomLocation.y = (rand() % window.getSize().y) / 32;
-	randomLocation.x = (int)randomLocation.x * 32;
-	randomLocation.y = (int)randomLocation.y * 32;
-	
-	return randomLocation;
 }
 
 /*****************************************************************************************************************
  *										renderFood()															 *
  *****************************************************************************************************************
- * Input: None																									 *
+ * Input: SpriteBatch the apple is added to																	 *
  * Output: None																									 *
- * Description: The purpose of this function is to render the next apple onto the game screen. This function     *
- * utilizes the private function setFoodLocaiton() to first set the new apple's in the case that the location    *
- * was altered. It then uses the RenderWindow passed as reference to render the image to the screen. It is the   *
- * responsibility of the user to call this function in a loop in order to constantly render the image onto the   *
- * window and to ensure the most recent foodLocation set is being rendered.								         *
+ * Description: The purpose of this function is to render the next apple onto the game screen. The apple is added *
+ * to the sprite batch at the most recent food location and is drawn together with the snake when the batch is  *
+ * rendered. It is the responsibility of the user to call this function in a loop in order to constantly render  *
+ * the image onto the window and to ensure the most recent food location is being rendered.					     *
  ****************************************************************************************************************/
 
-void Food::renderFood()
+void Food::renderFood(SpriteBatch& spriteBatch)
 {
-	setFoodLocation();
-	window.draw(food);
+	ScopedTimer timer(Phase::ID::RenderFood);
+	spriteBatch.addSprite(AtlasRegion::ID::Food, getFoodLocation());
 }
 
 /*****************************************************************************************************************
- *										generateNewFood()														 *
+ *										playBiteSound()														     *
  *****************************************************************************************************************
  * Input: None																									 *
  * Output: None																									 *
- * Description: The purpose of this function is set new x and y coordinates for the apple within the game. The   *
- * user need not worry about rendering the new location so long as the renderFood() function is constantly being *
- * called within some type of game/render loop. In order to use this function to its full capacity, it should be *
- * used in conjunction with the Snake's bool-returning class function "collidesWithFood". The function also      *
- * plays a "bite" noise whenever it is called to give a more immersive addition to the game.                     *
+ * Description: Plays a "bite" noise to give a more immersive addition to the game. Should be called whenever a  *
+ * step of the GameCore reports that the snake ate the food.													 *
  ****************************************************************************************************************/
-void Food::generateNewFood()
+void Food::playBiteSound()
 {
-	foodLocation = randomizeLocation();
+	TraceSpan span("playBiteSound", "audio");
 	biteSound.play();
 }
 
-/*****************************************************************************************************************
- *										setFoodLocation()  													     *
- *****************************************************************************************************************
- * Input: None																									 *
- * Output: None																									 *
- * Description: Generic private setter function to set the next food location									 *
- ****************************************************************************************************************/
-void Food::setFoodLocation()
-{
-	food.setPosition(foodLocation);
-}
-
 /*****************************************************************************************************************
  *										getFoodLocation()														 *
  *****************************************************************************************************************
  * Input: None																									 *
- * Output: sf::Vector2f of the food's current location															 *
- * Description: Generic private getter function that returns the food's current location.						 *
+ * Output: sf::Vector2f of the food's current location in pixels												 *
+ * Description: Converts the food's board cell into the pixel location it is drawn at.							 *
  ****************************************************************************************************************/
 sf::Vector2f Food::getFoodLocation()
 {
-	return food.getPosition();
+	return sf::Vector2f(static_cast<float>(core.getFood().x * SPRITE_DIMENSIONS), static_cast<float>(core.getFood().y * SPRITE_DIMENSIONS));
 }
@@ -1,30 +1,24 @@
 #ifndef FOOD_HPP
 #define FOOD_HPP
 
+#include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
 
-#include <stdlib.h>
-#include <time.h>
-
+#include "GameCore.hpp"
 #include "ResourceHolder.hpp"
+#include "SpriteBatch.hpp"
 
 
 class Food
 {
 	public:
-								Food(sf::RenderWindow& window, ResourceHolder& textureHolder);
+								Food(const GameCore& core, ResourceHolder& resourceHolder);
 		sf::Vector2f			getFoodLocation();
-		void					generateNewFood();
-		void					renderFood();
-
-	private:
-		sf::Vector2f			randomizeLocation();
-		void					setFoodLocation();
+		void					renderFood(SpriteBatch& spriteBatch);
+		void					playBiteSound();
 
 	private:
-		sf::Sprite			    food;
-		sf::Vector2f			foodLocation;
-		sf::RenderWindow&		window;
+		const GameCore&			core;
 		sf::Sound				biteSound;
 };
-#endif
\ No newline at end of file
+#endif
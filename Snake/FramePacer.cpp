@@ -0,0 +1,203 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: FramePacing to follow																					 *
+ * Output: None																									 *
+ * Description: The first frame is due right away.																 *
+ ****************************************************************************************************************/
+FramePacer::FramePacer(const FramePacing& pacing) : pacing(pacing), nextFrame(Clock::now()), lastFrame(nextFrame), wasIdle(true), framePresented(false)
+{
+	resetStats();
+}
+
+/*****************************************************************************************************************
+ *										defaultFramePacing()													 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: FramePacing of DEFAULT_TARGET_FPS while active and DEFAULT_IDLE_FPS while idle, without vsync		 *
+ * Description: The snake moves a few times a second, so 60 frames per second already looks smooth.			 *
+ ****************************************************************************************************************/
+FramePacing FramePacer::defaultFramePacing()
+{
+	FramePacing pacing = { false, DEFAULT_TARGET_FPS, DEFAULT_IDLE_FPS };
+	return pacing;
+}
+
+void FramePacer::setPacing(const FramePacing& newPacing)
+{
+	pacing = newPacing;
+}
+
+const FramePacing& FramePacer::getPacing() const
+{
+	return pacing;
+}
+
+/*****************************************************************************************************************
+ *										apply()																	 *
+ *****************************************************************************************************************
+ * Input: sf::Window the loop displays to																		 *
+ * Output: None																									 *
+ * Description: Switches the window's vsync on or off to match the pacing.										 *
+ ****************************************************************************************************************/
+void FramePacer::apply(sf::Window& window) const
+{
+	window.setVerticalSyncEnabled(pacing.vsync);
+}
+
+/*****************************************************************************************************************
+ *										wait()																	 *
+ *****************************************************************************************************************
+ * Input: bool indicating if the loop is idle (unfocused or paused)												 *
+ * Output: None																									 *
+ * Description: Call it once at the end of every frame. It waits until the next frame is due at the target rate, *
+ * or at the idle rate while idle. The OS sleep is coarse and wakes up late, so the limiter sleeps until		 *
+ * PACING_SPIN_MARGIN before the deadline and spins the rest of the way. Deadlines advance by one period at a	 *
+ * time so the rate does not drift, but a frame that ran long moves the schedule rather than being followed by	 *
+ * a burst of frames to catch up. Intervals between active frames are added to the stats.						 *
+ * With vsync on, a frame that was not displayed did not wait for the screen, so it is limited like any other.	 *
+ ****************************************************************************************************************/
+void FramePacer::wait(bool idle)
+{
+	// Vsync only holds the loop back on frames that were displayed
+	int fps = pacing.targetFps;
+	if (idle)
+	{
+		fps = pacing.idleFps;
+	}
+	else if (pacing.vsync)
+	{
+		fps = framePresented ? 0 : (pacing.targetFps > 0 ? pacing.targetFps : DEFAULT_TARGET_FPS);
+	}
+	framePresented = false;
+
+	if (fps > 0)
+	{
+		Clock::time_point now = Clock::now();
+		Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+		nextFrame = (idle != wasIdle) ? now + period : nextFrame + period;
+		if (nextFrame < now)
+		{
+			nextFrame = now;
+		}
+
+		Clock::duration sleep = nextFrame - now - std::chrono::microseconds(PACING_SPIN_MARGIN);
+		if (sleep > Clock::duration::zero())
+		{
+			sf::sleep(sf::microseconds(static_cast<sf::Int64>(std::chrono::duration_cast<std::chrono::microseconds>(sleep).count())));
+		}
+		while (Clock::now() < nextFrame)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	Clock::time_point end = Clock::now();
+	if (!idle && !wasIdle)
+	{
+		double interval = std::chrono::duration<double, std::milli>(end - lastFrame).count();
+		intervals++;
+		intervalSum += interval;
+		intervalSquares += interval * interval;
+		longestInterval = std::max(longestInterval, interval);
+	}
+	lastFrame = end;
+	wasIdle = idle;
+}
+
+/*****************************************************************************************************************
+ *										markPresented()															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Counts a frame that was drawn and displayed, to show how many frames dirty tracking skipped.	 *
+ ****************************************************************************************************************/
+void FramePacer::markPresented()
+{
+	presented++;
+	framePresented = true;
+}
+
+/*****************************************************************************************************************
+ *										getStats()																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: PacingStats since the pacer was built or the stats were reset										 *
+ * Description: The CPU use is the processor time of the whole process over the wall time, so 100% is one core  *
+ * kept busy.																									 *
+ ****************************************************************************************************************/
+PacingStats FramePacer::getStats() const
+{
+	PacingStats stats = { intervals, presented, 0.0, 0.0, longestInterval, 0.0 };
+	if (intervals > 0)
+	{
+		stats.meanIntervalMs = intervalSum / intervals;
+		stats.jitterMs = std::sqrt(std::max(0.0, intervalSquares / intervals - stats.meanIntervalMs * stats.meanIntervalMs));
+	}
+
+	double wall = std::chrono::duration<double>(Clock::now() - statsStart).count();
+	if (wall > 0.0)
+	{
+		stats.cpuPercent = 100.0 * (processCpuSeconds() - cpuStart) / wall;
+	}
+	return stats;
+}
+
+void FramePacer::resetStats()
+{
+	statsStart = Clock::now();
+	cpuStart = processCpuSeconds();
+	intervals = 0;
+	presented = 0;
+	intervalSum = 0.0;
+	intervalSquares = 0.0;
+	longestInterval = 0.0;
+}
+
+/*****************************************************************************************************************
+ *										processCpuSeconds()														 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: double seconds of processor time used by the process so far, user and kernel, on all threads			 *
+ * Description: Returns 0 when the platform does not report it.													 *
+ ****************************************************************************************************************/
+double processCpuSeconds()
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+	{
+		return 0.0;
+	}
+	// FILETIMEs count 100 ns intervals
+	ULARGE_INTEGER kernelTime, userTime;
+	kernelTime.LowPart = kernel.dwLowDateTime;
+	kernelTime.HighPart = kernel.dwHighDateTime;
+	userTime.LowPart = user.dwLowDateTime;
+	userTime.HighPart = user.dwHighDateTime;
+	return (kernelTime.QuadPart + userTime.QuadPart) / 1.0e7;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0.0;
+	}
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1.0e6;
+#endif
+}
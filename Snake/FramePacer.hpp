@@ -0,0 +1,68 @@
+#ifndef FRAMEPACER_HPP
+#define FRAMEPACER_HPP
+
+#include <chrono>
+
+#include <SFML/Graphics.hpp>
+
+// Frames per second of the game and menu loops while they have focus, 0 for as fast as possible
+#define DEFAULT_TARGET_FPS 60
+// Frames per second while the window is in the background or the game is paused
+#define DEFAULT_IDLE_FPS 10
+// Microseconds before a frame is due that the limiter stops sleeping and spins, to absorb late wake ups
+#define PACING_SPIN_MARGIN 1500
+
+// How a loop waits between frames. With vsync on the display call waits for the screen and the limiter only
+// runs while idle, since the two would fight over the same frames
+struct FramePacing
+{
+	bool					vsync;
+	int						targetFps;
+	int						idleFps;
+};
+
+// Frame intervals measured while the loop was not idle. The jitter is their standard deviation. Frames that had
+// nothing new to show are not presented
+struct PacingStats
+{
+	long long				frames;
+	long long				presentedFrames;
+	double					meanIntervalMs;
+	double					jitterMs;
+	double					longestIntervalMs;
+	double					cpuPercent;
+};
+
+class FramePacer
+{
+	public:
+		explicit				FramePacer(const FramePacing& pacing = defaultFramePacing());
+		static FramePacing		defaultFramePacing();
+		void					setPacing(const FramePacing& pacing);
+		const FramePacing&		getPacing() const;
+		void					apply(sf::Window& window) const;
+		void					wait(bool idle);
+		void					markPresented();
+		PacingStats				getStats() const;
+		void					resetStats();
+
+	private:
+		typedef std::chrono::steady_clock	Clock;
+
+	private:
+		FramePacing				pacing;
+		Clock::time_point		nextFrame;
+		Clock::time_point		lastFrame;
+		Clock::time_point		statsStart;
+		double					cpuStart;
+		bool					wasIdle;
+		bool					framePresented;
+		long long				intervals;
+		long long				presented;
+		double					intervalSum;
+		double					intervalSquares;
+		double					longestInterval;
+};
+
+double						processCpuSeconds();
+#endif
@@ -0,0 +1,324 @@
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+	const char* const phaseNames[Phase::Count] = { "frame", "processEvents", "update", "render", "renderBackground",
+		"renderHud", "renderSnake", "renderFood", "spriteBatch", "display", "overlay" };
+
+	int highestBit(std::uint64_t value)
+	{
+		int bit = 0;
+		while (value >>= 1)
+		{
+			bit++;
+		}
+		return bit;
+	}
+
+	// Values under PROFILE_SUB_BUCKETS get a bucket each, larger ones share PROFILE_SUB_BUCKETS buckets per power of two
+	int bucketOf(std::uint64_t nanoseconds)
+	{
+		if (nanoseconds < PROFILE_SUB_BUCKETS)
+		{
+			return static_cast<int>(nanoseconds);
+		}
+		int bit = highestBit(nanoseconds);
+		int sub = static_cast<int>((nanoseconds >> (bit - 4)) & (PROFILE_SUB_BUCKETS - 1));
+		return (bit - 3) * PROFILE_SUB_BUCKETS + sub;
+	}
+
+	std::uint64_t bucketLow(int bucket)
+	{
+		if (bucket < PROFILE_SUB_BUCKETS)
+		{
+			return static_cast<std::uint64_t>(bucket);
+		}
+		int bit = bucket / PROFILE_SUB_BUCKETS + 3;
+		std::uint64_t sub = static_cast<std::uint64_t>(bucket % PROFILE_SUB_BUCKETS);
+		return (PROFILE_SUB_BUCKETS + sub) << (bit - 4);
+	}
+
+	std::uint64_t bucketHigh(int bucket)
+	{
+		return bucketLow(bucket + 1);
+	}
+}
+
+std::atomic<bool> FrameProfiler::enabled(false);
+
+/*****************************************************************************************************************
+ *										instance()																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: FrameProfiler& shared by the whole program															 *
+ * Description: There is one game loop, so there is one profiler. It is built on first use.						 *
+ ****************************************************************************************************************/
+FrameProfiler& FrameProfiler::instance()
+{
+	static FrameProfiler profiler;
+	return profiler;
+}
+
+void FrameProfiler::setEnabled(bool on)
+{
+	enabled.store(on, std::memory_order_relaxed);
+}
+
+FrameProfiler::FrameProfiler() : head(0), tail(0)
+{
+	reset();
+}
+
+/*****************************************************************************************************************
+ *										reset()																	 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Forgets every frame recorded so far. Must be called from the thread that runs the game loop.	 *
+ ****************************************************************************************************************/
+void FrameProfiler::reset()
+{
+	tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+	dropped = 0;
+	frameStart = 0;
+	frames = 0;
+	std::fill(&frameTotals[0], &frameTotals[0] + Phase::Count, 0);
+	std::fill(&frameRan[0], &frameRan[0] + Phase::Count, false);
+	std::fill(&histogram[0][0], &histogram[0][0] + Phase::Count * PROFILE_BUCKETS, 0);
+	std::fill(&samples[0], &samples[0] + Phase::Count, 0);
+	std::fill(&totalNanoseconds[0], &totalNanoseconds[0] + Phase::Count, 0.0);
+	std::fill(&history[0], &history[0] + PROFILE_HISTORY, 0.0f);
+}
+
+/*****************************************************************************************************************
+ *										record()																 *
+ *****************************************************************************************************************
+ * Input: Phase::ID the time belongs to, start and end time from now()											 *
+ * Output: None																									 *
+ * Description: Pushes one timed region onto the ring. Only the game loop's thread pushes and only endFrame()	 *
+ * pops, so the two ends need no lock: the slot is written before the new head is published with release		 *
+ * order. A full ring drops the sample and counts it rather than waiting.										 *
+ ****************************************************************************************************************/
+void FrameProfiler::record(Phase::ID phase, std::uint64_t start, std::uint64_t end)
+{
+	std::uint32_t position = head.load(std::memory_order_relaxed);
+	if (position - tail.load(std::memory_order_acquire) >= PROFILE_RING_SIZE)
+	{
+		dropped++;
+		return;
+	}
+
+	Sample& sample = ring[position & (PROFILE_RING_SIZE - 1)];
+	sample.start = start;
+	sample.nanoseconds = static_cast<std::uint32_t>(std::min<std::uint64_t>(end - start, 0xFFFFFFFFu));
+	sample.phase = static_cast<std::uint32_t>(phase);
+	head.store(position + 1, std::memory_order_release);
+}
+
+/*****************************************************************************************************************
+ *										beginFrame()															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Starts timing a frame. Call it at the top of every iteration of the game loop.					 *
+ ****************************************************************************************************************/
+void FrameProfiler::beginFrame()
+{
+	if (!isEnabled())
+	{
+		frameStart = 0;
+		return;
+	}
+
+	// Regions left over from before profiling was switched on do not belong to this frame
+	drain();
+	std::fill(&frameTotals[0], &frameTotals[0] + Phase::Count, 0);
+	std::fill(&frameRan[0], &frameRan[0] + Phase::Count, false);
+	frameStart = now();
+}
+
+/*****************************************************************************************************************
+ *										endFrame()																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Ends the frame started by beginFrame(). The regions pushed during the frame are summed per		 *
+ * phase, since update() runs once per tick and a frame may hold several ticks, and every phase that ran adds	 *
+ * its total to its histogram. The length of the whole frame goes to the Frame phase and to the graph history.	 *
+ ****************************************************************************************************************/
+void FrameProfiler::endFrame()
+{
+	if (frameStart == 0)
+	{
+		return;
+	}
+
+	std::uint64_t frameTime = now() - frameStart;
+	frameStart = 0;
+	drain();
+	frameTotals[Phase::Frame] = frameTime;
+	frameRan[Phase::Frame] = true;
+
+	for (int phase = 0; phase < Phase::Count; phase++)
+	{
+		if (frameRan[phase])
+		{
+			histogram[phase][bucketOf(frameTotals[phase])]++;
+			samples[phase]++;
+			totalNanoseconds[phase] += static_cast<double>(frameTotals[phase]);
+		}
+	}
+
+	history[frames % PROFILE_HISTORY] = static_cast<float>(frameTime / 1.0e6);
+	frames++;
+}
+
+/*****************************************************************************************************************
+ *										drain()																	 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Pops every region on the ring into the running totals of the frame.								 *
+ ****************************************************************************************************************/
+void FrameProfiler::drain()
+{
+	std::uint32_t position = tail.load(std::memory_order_relaxed);
+	std::uint32_t end = head.load(std::memory_order_acquire);
+	for (; position != end; position++)
+	{
+		const Sample& sample = ring[position & (PROFILE_RING_SIZE - 1)];
+		frameTotals[sample.phase] += sample.nanoseconds;
+		frameRan[sample.phase] = true;
+	}
+	tail.store(end, std::memory_order_release);
+}
+
+/*****************************************************************************************************************
+ *										getStats()																 *
+ *****************************************************************************************************************
+ * Input: Phase::ID																								 *
+ * Output: PhaseStats of every frame the phase ran in															 *
+ * Description: The percentiles are read from the histogram and reported as the middle of their bucket.			 *
+ ****************************************************************************************************************/
+PhaseStats FrameProfiler::getStats(Phase::ID phase) const
+{
+	PhaseStats stats = { samples[phase], 0.0, 0.0, 0.0, 0.0 };
+	if (stats.samples == 0)
+	{
+		return stats;
+	}
+	stats.meanMs = totalNanoseconds[phase] / stats.samples / 1.0e6;
+
+	const double fractions[] = { 0.50, 0.95, 0.99 };
+	double* results[] = { &stats.p50Ms, &stats.p95Ms, &stats.p99Ms };
+	for (int i = 0; i < 3; i++)
+	{
+		long long rank = static_cast<long long>(std::ceil(fractions[i] * stats.samples));
+		long long seen = 0;
+		for (int bucket = 0; bucket < PROFILE_BUCKETS; bucket++)
+		{
+			seen += histogram[phase][bucket];
+			if (seen >= rank)
+			{
+				*results[i] = (bucketLow(bucket) + bucketHigh(bucket)) / 2.0e6;
+				break;
+			}
+		}
+	}
+	return stats;
+}
+
+long long FrameProfiler::getFrameCount() const
+{
+	return frames;
+}
+
+long long FrameProfiler::getDropped() const
+{
+	return dropped;
+}
+
+/*****************************************************************************************************************
+ *										getFrameHistory()														 *
+ *****************************************************************************************************************
+ * Input: int age of the frame, 0 for the last one																 *
+ * Output: float frame time in milliseconds, 0 for frames older than PROFILE_HISTORY or not yet played			 *
+ * Description: Used by the overlay to draw the frame time graph.												 *
+ ****************************************************************************************************************/
+float FrameProfiler::getFrameHistory(int age) const
+{
+	if (age < 0 || age >= PROFILE_HISTORY || age >= frames)
+	{
+		return 0.0f;
+	}
+	return history[(frames - 1 - age) % PROFILE_HISTORY];
+}
+
+/*****************************************************************************************************************
+ *										save()																	 *
+ *****************************************************************************************************************
+ * Input: std::string& file name, ending in .csv for CSV and anything else for JSON								 *
+ * Output: bool indicating if the file was written																 *
+ * Description: Writes the histogram of every phase. The CSV holds one row per non-empty bucket, the JSON adds	 *
+ * the mean and percentiles of each phase.																		 *
+ ****************************************************************************************************************/
+bool FrameProfiler::save(const std::string& filename) const
+{
+	if (filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0)
+	{
+		return saveCsv(filename);
+	}
+	return saveJson(filename);
+}
+
+bool FrameProfiler::saveCsv(const std::string& filename) const
+{
+	std::ofstream file(filename);
+	file << "phase,bucket_low_ns,bucket_high_ns,count\n";
+	for (int phase = 0; phase < Phase::Count; phase++)
+	{
+		for (int bucket = 0; bucket < PROFILE_BUCKETS; bucket++)
+		{
+			if (histogram[phase][bucket] != 0)
+			{
+				file << phaseNames[phase] << ',' << bucketLow(bucket) << ',' << bucketHigh(bucket) << ',' << histogram[phase][bucket] << '\n';
+			}
+		}
+	}
+	return static_cast<bool>(file);
+}
+
+bool FrameProfiler::saveJson(const std::string& filename) const
+{
+	std::ofstream file(filename);
+	file << "{\n  \"frames\": " << frames << ",\n  \"dropped\": " << dropped << ",\n  \"phases\": [\n";
+	for (int phase = 0; phase < Phase::Count; phase++)
+	{
+		PhaseStats stats = getStats(static_cast<Phase::ID>(phase));
+		file << "    { \"phase\": \"" << phaseNames[phase] << "\", \"samples\": " << stats.samples
+			<< ", \"mean_ms\": " << stats.meanMs << ", \"p50_ms\": " << stats.p50Ms << ", \"p95_ms\": " << stats.p95Ms
+			<< ", \"p99_ms\": " << stats.p99Ms << ", \"histogram\": [";
+
+		bool first = true;
+		for (int bucket = 0; bucket < PROFILE_BUCKETS; bucket++)
+		{
+			if (histogram[phase][bucket] != 0)
+			{
+				file << (first ? "" : ", ") << '[' << bucketLow(bucket) << ", " << bucketHigh(bucket) << ", " << histogram[phase][bucket] << ']';
+				first = false;
+			}
+		}
+		file << "] }" << (phase + 1 < Phase::Count ? "," : "") << '\n';
+	}
+	file << "  ]\n}\n";
+	return static_cast<bool>(file);
+}
+
+const char* phaseName(Phase::ID phase)
+{
+	return phaseNames[phase];
+}
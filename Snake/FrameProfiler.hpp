@@ -0,0 +1,134 @@
+#ifndef FRAMEPROFILER_HPP
+#define FRAMEPROFILER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "Trace.hpp"
+
+// Size of a cache line, to keep the two ends of the sample ring from sharing one
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+// Timed regions the ring holds before the end of the frame drains it, a power of two
+#define PROFILE_RING_SIZE 4096
+// Buckets of a phase histogram: 16 per power of two of nanoseconds, so every bucket is within 6% of its samples
+#define PROFILE_SUB_BUCKETS 16
+#define PROFILE_BUCKETS 1024
+// Most recent frame times kept for the overlay's graph
+#define PROFILE_HISTORY 240
+
+namespace Phase
+{
+	enum ID { Frame, ProcessEvents, Update, Render, RenderBackground, RenderHud, RenderSnake, RenderFood, RenderBatch, Display, Overlay, Count };
+};
+
+struct PhaseStats
+{
+	long long				samples;
+	double					meanMs;
+	double					p50Ms;
+	double					p95Ms;
+	double					p99Ms;
+};
+
+// Records how long every phase of a frame takes. Timed regions are pushed onto a lock-free ring by the thread
+// that runs the game loop and folded into one histogram per phase at the end of the frame, so a ScopedTimer
+// costs two clock reads and a few stores. While profiling is off a ScopedTimer only tests a flag
+class FrameProfiler
+{
+	public:
+		static FrameProfiler&	instance();
+		static bool				isEnabled();
+		static void				setEnabled(bool on);
+		static std::uint64_t	now();
+
+		void					beginFrame();
+		void					endFrame();
+		void					record(Phase::ID phase, std::uint64_t start, std::uint64_t end);
+		PhaseStats				getStats(Phase::ID phase) const;
+		long long				getFrameCount() const;
+		long long				getDropped() const;
+		float					getFrameHistory(int age) const;
+		void					reset();
+		bool					save(const std::string& filename) const;
+
+	private:
+								FrameProfiler();
+		void					drain();
+		bool					saveJson(const std::string& filename) const;
+		bool					saveCsv(const std::string& filename) const;
+
+	private:
+		struct Sample
+		{
+			std::uint64_t		start;
+			std::uint32_t		nanoseconds;
+			std::uint32_t		phase;
+		};
+
+	private:
+		static std::atomic<bool>				enabled;
+
+		alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t>	head;
+		alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t>	tail;
+		alignas(CACHE_LINE_SIZE) Sample			ring[PROFILE_RING_SIZE];
+		long long								dropped;
+		std::uint64_t							frameStart;
+		std::uint64_t							frameTotals[Phase::Count];
+		bool									frameRan[Phase::Count];
+		long long								histogram[Phase::Count][PROFILE_BUCKETS];
+		long long								samples[Phase::Count];
+		double									totalNanoseconds[Phase::Count];
+		long long								frames;
+		float									history[PROFILE_HISTORY];
+};
+
+const char*					phaseName(Phase::ID phase);
+
+// Adds the time from its construction to its destruction to a phase of the current frame, and records it as a
+// span of the trace while one is being written
+class ScopedTimer
+{
+	public:
+		explicit				ScopedTimer(Phase::ID phase) : phase(phase),
+								start(FrameProfiler::isEnabled() || Trace::isEnabled() ? FrameProfiler::now() : 0)
+		{
+		}
+
+								~ScopedTimer()
+		{
+			if (start != 0)
+			{
+				std::uint64_t end = FrameProfiler::now();
+				if (FrameProfiler::isEnabled())
+				{
+					FrameProfiler::instance().record(phase, start, end);
+				}
+				if (Trace::isEnabled())
+				{
+					Trace::complete(phaseName(phase), "frame", start, end);
+				}
+			}
+		}
+
+	private:
+								ScopedTimer(const ScopedTimer&);
+		ScopedTimer&			operator=(const ScopedTimer&);
+
+	private:
+		Phase::ID				phase;
+		std::uint64_t			start;
+};
+
+inline bool FrameProfiler::isEnabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+inline std::uint64_t FrameProfiler::now()
+{
+	return Trace::now();
+}
+#endif
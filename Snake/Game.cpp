@@ -1,23 +1,76 @@
 #include "Game.hpp"
 
+#include <algorithm>
+
 /*****************************************************************************************************************
  *										Constructor   															 *
  *****************************************************************************************************************
- * Input: sf::RenderWindow																						 *
+ * Input: sf::RenderWindow, unsigned int seed for the game's random number generator, optional texture to draw  *
+ *        into instead of the window																			 *
  * Output: None																									 *
  * Description: The constructor of the game class initializes the render window. It then loads all textures      *
- * soundBuffers, and fonts. It then sets the background of the game and finally initializes instances of the     *
- * Snake, Food, and ScoreBoard classes.																			 *
+ * soundBuffers, and fonts, decoding the files in parallel. It then initializes the GameCore, which              *
+ * plays the game on a board of BODY_DIMENSIONS sized cells covering the window, and the Snake, Food, and        *
+ * Hud views of it along with the sprite batch they are drawn through. The HUD_ROWS rows under the HUD text      *
+ * are excluded from food placement so the food is never hidden behind the text. The board is read from its	 *
+ * tile map, which adds its walls to the GameCore. Every tick of the session is recorded, see saveReplay().		 *
+ * With an offscreen texture every frame is drawn into the texture and the board takes its size. The window is	 *
+ * still polled for events but need not be open, so the game runs on machines without a display.				 *
+ ****************************************************************************************************************/
+Game::Game(sf::RenderWindow& window, unsigned int seed, sf::RenderTexture* offscreen) : Game(window, seed, nullptr, offscreen)
+{
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: sf::RenderWindow, Replay to play back, which must outlive the game, optional offscreen texture		 *
+ * Output: None																									 *
+ * Description: Builds a game that plays a recorded session back in the window at normal speed instead of        *
+ * listening to the keyboard. The replay must have been recorded on a board the size of the window (or of the	 *
+ * offscreen texture).																							 *
+ ****************************************************************************************************************/
+Game::Game(sf::RenderWindow& window, const Replay& replay, sf::RenderTexture* offscreen) : Game(window, replay.getHeader().seed, &replay,
+offscreen)
+{
+	mReplayInputs = std::unique_ptr<ReplayCursor>(new ReplayCursor(replay.getInputs()));
+	mReplayTicks = replay.getHeader().tickCount;
+}
+
+/*****************************************************************************************************************
+ *										Constructor																 *
+ *****************************************************************************************************************
+ * Input: sf::RenderWindow, unsigned int seed, Replay whose walls the GameCore takes or nullptr, texture or		 *
+ * nullptr																										 *
+ * Output: None																									 *
+ * Description: The common part of both public constructors, see above.											 *
  ****************************************************************************************************************/
-Game::Game(sf::RenderWindow& window) : mWindow(window)
+Game::Game(sf::RenderWindow& window, unsigned int seed, const Replay* replay, sf::RenderTexture* offscreen) : mWindow(window),
+mOffscreen(offscreen),
+mTarget(offscreen ? static_cast<sf::RenderTarget&>(*offscreen) : window), mTick(0),
+mRecorder(seed, mTarget.getSize().x / BODY_DIMENSIONS, mTarget.getSize().y / BODY_DIMENSIONS, HUD_ROWS), mReplayTicks(0),
+mFocused(true), mPaused(false), mDirty(true)
 {
 	loadTextures();
 	loadSoundBuffers();
 	loadFonts();
-	setBackgroundTile();
-	mSnake = std::unique_ptr<Snake>(new Snake(mWindow, gameResourceHolder));
-	mFood = std::unique_ptr<Food>(new Food(mWindow, gameResourceHolder));
-	mScoreBoard = std::unique_ptr<ScoreBoard>(new ScoreBoard(mWindow, gameResourceHolder));
+	gameResourceHolder.loadQueued();
+	mSpriteBatch = std::unique_ptr<SpriteBatch>(new SpriteBatch(mTarget, gameResourceHolder.getTextures(Textures::ID::Atlas)));
+	mCore = std::unique_ptr<GameCore>(new GameCore(mTarget.getSize().x / BODY_DIMENSIONS, mTarget.getSize().y / BODY_DIMENSIONS, seed));
+	for (int y = 0; y < HUD_ROWS; y++)
+	{
+		for (int x = 0; x < mCore->getBoardWidth(); x++)
+		{
+			mCore->excludeFromFood(x, y);
+		}
+	}
+	loadBoard(replay);
+	mNextDirection = mCore->getDirection();
+	mSnake = std::unique_ptr<Snake>(new Snake(*mCore, gameResourceHolder));
+	mFood = std::unique_ptr<Food>(new Food(*mCore, gameResourceHolder));
+	mHud = std::unique_ptr<Hud>(new Hud(gameResourceHolder.getTextures(Textures::ID::Atlas), gameResourceHolder.getFont(Fonts::ID::Bauhaus)));
+	updateHud();
+	mProfilerOverlay = std::unique_ptr<ProfilerOverlay>(new ProfilerOverlay(mTarget, gameResourceHolder.getFont(Fonts::ID::Bauhaus)));
 }
 
 /*****************************************************************************************************************
@@ -30,18 +83,71 @@ Game::Game(sf::RenderWindow& window) : mWindow(window)
  * all of the data of the snake game which include the snake, food, the game board, and any collisions that may  *
  * occur within the game. It also updates the score of the game. The user need not worry about the details of    *
  * game and only need to call the run function to play the entire game gameState.								 *
+ * The simulation runs on a fixed tick: the elapsed time of every frame is added to an accumulator and the game  *
+ * is updated once for every full tick the accumulator holds. A slow frame is caught up with several ticks, up   *
+ * to MAX_CATCH_UP_TICKS, and rendering happens once per frame regardless of how many ticks ran.				 *
+ * Every iteration is one frame of the FrameProfiler and one span of the trace.								 *
+ * The frame pacer then waits for the next frame. While the game is paused or the window is in the background	 *
+ * the simulation stands still, the clock is not allowed to build up a backlog of ticks, and frames come at the	 *
+ * idle rate.																									 *
+ * The board only changes on a tick, so a frame without ticks and without window events that need a redraw is	 *
+ * not drawn or displayed at all; the window keeps showing the last frame. The profiler overlay is drawn every	 *
+ * frame while it is shown, since its graph moves. Once a second the frames presented in that second go to the	 *
+ * FPS readout of the HUD, which redraws the frame if the number changed.										 *
  ****************************************************************************************************************/
 void Game::run()
 {
 	sf::Clock clock;
-	sf::Time deltaTime = sf::Time::Zero;
-	
+	sf::Time accumulator = sf::Time::Zero;
+	sf::Clock fpsClock;
+	int presentedFrames = 0;
+	mPacer.resetStats();
+
 	while (mWindow.isOpen())
 	{
-		deltaTime = clock.restart();
+		TraceSpan frameSpan("frame", "game");
+		FrameProfiler::instance().beginFrame();
+		accumulator += clock.restart();
 		processEvents();
-		update(deltaTime);
-		render();
+
+		bool idle = mPaused || !mFocused;
+		if (idle)
+		{
+			accumulator = sf::Time::Zero;
+		}
+
+		int ticks = 0;
+		while (accumulator >= sf::seconds(static_cast<float>(mCore->getTickDuration())) && ticks < MAX_CATCH_UP_TICKS)
+		{
+			accumulator -= sf::seconds(static_cast<float>(mCore->getTickDuration()));
+			update();
+			ticks++;
+		}
+
+		// After a long stall (dragging the window, a breakpoint) drop the backlog rather than fast forwarding
+		if (ticks == MAX_CATCH_UP_TICKS && accumulator >= sf::seconds(static_cast<float>(mCore->getTickDuration())))
+		{
+			accumulator = sf::Time::Zero;
+		}
+
+		if (fpsClock.getElapsedTime() >= sf::seconds(1.0f))
+		{
+			mDirty = mHud->setValue(Readout::ID::Fps, presentedFrames) || mDirty;
+			presentedFrames = 0;
+			fpsClock.restart();
+		}
+
+		if (mDirty || mProfilerOverlay->isVisible())
+		{
+			render();
+			mDirty = false;
+			mPacer.markPresented();
+			presentedFrames++;
+		}
+		FrameProfiler::instance().endFrame();
+
+		TraceSpan waitSpan("wait", "pacing");
+		mPacer.wait(idle);
 	}
 }
 
@@ -53,10 +159,12 @@ void Game::run()
  * Description: The function is used to process any user events that occur within the menu gamestate. This would *
  * incude whether a button is clicked or if the window is closed. The function specifically processes if the     *
  * user clicks 'W', 'A', 'S', and 'D', changing the direction the snake faces to Up, Left, Down, and Right,      *
- * respectively.																								 *
+ * respectively. Losing the focus pauses the game until the window gets it back, since the snake cannot be	 *
+ * steered in the meantime.																						 *
  ****************************************************************************************************************/
 void Game::processEvents()
 {
+	ScopedTimer timer(Phase::ID::ProcessEvents);
 	sf::Event event;
 	while (mWindow.pollEvent(event))
 	{
@@ -73,6 +181,22 @@ void Game::processEvents()
 				mWindow.close();
 				break;
 			}
+			case sf::Event::LostFocus:
+			{
+				mFocused = false;
+				break;
+			}
+			case sf::Event::GainedFocus:
+			{
+				mFocused = true;
+				mDirty = true;
+				break;
+			}
+			case sf::Event::Resized:
+			{
+				mDirty = true;
+				break;
+			}
 		}
 	}
 }
@@ -82,17 +206,115 @@ void Game::processEvents()
  *****************************************************************************************************************
  * Input: None																									 *
  * Output: None																									 *
- * Description: The following function is a general update function that updates any classes within the game     *
- * as necessary. In this case, the Snake class is updated every iteration to ensure that it moves the board      *
- * at a given rate per iteration. Also, the snake is checked every iteration to see if it collides with a food   *
- * object. Finally, the score is updated every iteration if necessary if the length of the snake increases or    *
- * decreases																									 *
+ * Description: The following function is a general update function that advances the game by one simulation    *
+ * tick. The GameCore moves the snake one cell in the direction most recently chosen by the player and reports   *
+ * whether the snake ate the food or died, which the views answer with their sound effects. A finished game is   *
+ * reset right away. Finally, the HUD readouts are updated, which only lays out the ones that changed.			 *
+ * While the autopilot is on it chooses the direction in place of the player.									 *
+ * The direction of every tick is recorded, or taken from the replay when one is playing. ReplayPlayer repeats  *
+ * these rules, so changes here must be mirrored there to keep replays exact.									 *
+ ****************************************************************************************************************/
+void Game::update()
+{
+	ScopedTimer timer(Phase::ID::Update);
+	if (mReplayInputs)
+	{
+		// The replay is over, keep showing its last frame
+		if (mTick >= mReplayTicks)
+		{
+			return;
+		}
+		mNextDirection = mReplayInputs->directionAt(mTick);
+	}
+	else
+	{
+		if (mAutopilot)
+		{
+			mNextDirection = mAutopilot->decide(*mCore);
+		}
+		mRecorder.record(mTick, mNextDirection);
+	}
+
+	int events = mCore->step(mNextDirection);
+	mDirty = true;
+
+	if (events & GameEvent::AteFood)
+	{
+		mFood->playBiteSound();
+	}
+	if (events & GameEvent::Died)
+	{
+		mSnake->playDeathSound();
+	}
+	if (mCore->isGameOver())
+	{
+		mCore->reset();
+		mNextDirection = mCore->getDirection();
+	}
+	mTick++;
+
+	updateHud();
+}
+
+/*****************************************************************************************************************
+ *										saveReplay() 															 *
+ *****************************************************************************************************************
+ * Input: std::string& indicating the file name																	 *
+ * Output: bool indicating if the replay was written															 *
+ * Description: Saves every tick played so far as a replay file that can be opened with a Replay. A session		 *
+ * that never played a tick, such as one closed from the menu, writes nothing and returns false, so the last	 *
+ * replay on disk is kept.																						 *
+ ****************************************************************************************************************/
+bool Game::saveReplay(const std::string& filename) const
+{
+	if (mTick == 0)
+	{
+		return false;
+	}
+	return mRecorder.save(filename, mTick);
+}
+
+/*****************************************************************************************************************
+ *										setFramePacing()														 *
+ *****************************************************************************************************************
+ * Input: FramePacing for the game loop																			 *
+ * Output: None																									 *
+ * Description: Sets the frame rate limits of run() and switches the window's vsync to match. The vsync of an	 *
+ * offscreen texture is left alone, there is no screen to wait for.												 *
+ ****************************************************************************************************************/
+void Game::setFramePacing(const FramePacing& pacing)
+{
+	mPacer.setPacing(pacing);
+	if (!mOffscreen)
+	{
+		mPacer.apply(mWindow);
+	}
+}
+
+/*****************************************************************************************************************
+ *										getPacingStats()														 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: PacingStats of the frames run() has played															 *
+ * Description: Frame interval, jitter and CPU use, to compare pacing settings.									 *
+ ****************************************************************************************************************/
+PacingStats Game::getPacingStats() const
+{
+	return mPacer.getStats();
+}
+
+/*****************************************************************************************************************
+ *										updateHud()																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Hands the score, the length and the speed in moves per second of the GameCore to the HUD.		 *
  ****************************************************************************************************************/
-void Game::update(sf::Time deltaTime)
+void Game::updateHud()
 {
-	mSnake->moveForward(deltaTime);
-	mSnake->collidesWithFood(mFood);
-	mScoreBoard->updateScore(mSnake);
+	mHud->setValue(Readout::ID::Score, mCore->getScore());
+	mHud->setValue(Readout::ID::Length, mCore->getLength());
+	mHud->setValue(Readout::ID::Speed, static_cast<int>(1.0 / mCore->getTickDuration() + 0.5));
 }
 
 /*****************************************************************************************************************
@@ -101,17 +323,34 @@ void Game::update(sf::Time deltaTime)
  * Input: None																									 *
  * Output: None																									 *
  * Description: The following function renders all sprites and backgrounds to the screen. The render function    *
- * ensures that the background, snake, food, and scoreboard are rendered per iteration. Before rendering all     *
- * classes, it clears the entire screen to ensure no overlap occurs between images								 *
+ * ensures that the background, snake, food, and HUD are rendered per iteration. Before rendering all     *
+ * classes, it clears the entire screen to ensure no overlap occurs between images. Everything comes from the	 *
+ * atlas, so a frame binds a single texture and takes two draw calls regardless of the snake's length: the		 *
+ * board from the tile map's vertex buffer, which never changes, then the HUD, the snake and the food,			 *
+ * collected into the sprite batch in that order.																 *
+ * The profiler overlay, when shown, is drawn over everything else.											 *
  ****************************************************************************************************************/
 void Game::render()
 {
-	mWindow.clear();
+	ScopedTimer timer(Phase::ID::Render);
+	mTarget.clear();
 	renderBackground();
-	mScoreBoard->renderScore();
-	mSnake->renderSnake();
-	mFood->renderFood();
-	mWindow.display();
+	mSpriteBatch->clear();
+	mHud->render(*mSpriteBatch);
+	mSnake->renderSnake(*mSpriteBatch);
+	mFood->renderFood(*mSpriteBatch);
+	mSpriteBatch->render();
+	mProfilerOverlay->render();
+
+	ScopedTimer displayTimer(Phase::ID::Display);
+	if (mOffscreen)
+	{
+		mOffscreen->display();
+	}
+	else
+	{
+		mWindow.display();
+	}
 }
 
 /*****************************************************************************************************************
@@ -120,27 +359,48 @@ void Game::render()
  * Input: None																									 *
  * Output: None																									 *
  * Description: The following function handles any keyboard input from the user. If 'W', 'S', 'A', or 'D' are    *
- * pressed, their directions are changed accordingly.															 *
+ * pressed, their directions are changed accordingly. The direction is handed to the GameCore on the next tick.  *
+ * 'P' switches the autopilot on and off. Input is ignored while a replay is playing.							 *
+ * F3 shows and hides the profiler overlay and space pauses and resumes the game, during replays too.			 *
  ****************************************************************************************************************/
 void Game::handlePlayerInput(sf::Keyboard::Key key, bool isPressed)
 {
+	if (key == sf::Keyboard::F3)
+	{
+		mProfilerOverlay->toggle();
+		mDirty = true;
+	}
+	if (key == sf::Keyboard::Space)
+	{
+		mPaused = !mPaused;
+	}
+
+	// A replay plays its own recorded inputs
+	if (mReplayInputs)
+	{
+		return;
+	}
 
 	// change the direction the snake if facing
 	if (key == sf::Keyboard::W)
 	{
-		mSnake->changeDirection(Up);
+		mNextDirection = Up;
 	}
 	if (key == sf::Keyboard::S)
 	{
-		mSnake->changeDirection(Down);
+		mNextDirection = Down;
 	}
 	if (key == sf::Keyboard::A)
 	{
-		mSnake->changeDirection(Left);
+		mNextDirection = Left;
 	}
 	if (key == sf::Keyboard::D)
 	{
-		mSnake->changeDirection(Right);
+		mNextDirection = Right;
+	}
+	if (key == sf::Keyboard::P)
+	{
+		mAutopilot = mAutopilot ? std::unique_ptr<Policy>() : createPolicy("autopilot", 0);
 	}
 
 	
@@ -151,16 +411,13 @@ void Game::handlePlayerInput(sf::Keyboard::Key key, bool isPressed)
  *****************************************************************************************************************
  * Input: None																									 *
  * Output: None																									 *
- * Description: The function loads the game's textures into the game's resourceHolder instance for later         *
- * use.																											 *
+ * Description: The function queues the game's textures on the game's resourceHolder instance for later          *
+ * use. The board, the snake, the food and the tile set are all regions of one atlas, which SnakeAtlas packs	 *
+ * from their images at build time, see AtlasLayout.hpp.														 *
  ****************************************************************************************************************/
 void Game::loadTextures()
 {
-	gameResourceHolder.loadTextures(Textures::ID::TileSet, "Media/Textures/Textures.png");
-	gameResourceHolder.loadTextures(Textures::ID::Background, "Media/Textures/SnakeBoard.png");
-	gameResourceHolder.loadTextures(Textures::ID::Head, "Media/Textures/SnakeHead.png");
-	gameResourceHolder.loadTextures(Textures::ID::Torso, "Media/Textures/SnakeTorso.png");
-	gameResourceHolder.loadTextures(Textures::ID::Veggies, "Media/Textures/Vegies.png");
+	gameResourceHolder.queueTextures(Textures::ID::Atlas, ATLAS_FILE);
 }
 
 /*****************************************************************************************************************
@@ -168,13 +425,13 @@ void Game::loadTextures()
  *****************************************************************************************************************
  * Input: None																									 *
  * Output: None																									 *
- * Description: The function loads the game's sound buffers into the game's resourceHolder instance for later    *
+ * Description: The function queues the game's sound buffers on the game's resourceHolder instance for later     *
  * use.																											 *
  ****************************************************************************************************************/
 void Game::loadSoundBuffers()
 {
-	gameResourceHolder.loadSoundBuffers(SoundBuffers::ID::Munch, "Media/SoundBuffers/Munch.wav");
-	gameResourceHolder.loadSoundBuffers(SoundBuffers::ID::Death, "Media/SoundBuffers/Lose.wav");
+	gameResourceHolder.queueSoundBuffers(SoundBuffers::ID::Munch, "Media/SoundBuffers/Munch.wav");
+	gameResourceHolder.queueSoundBuffers(SoundBuffers::ID::Death, "Media/SoundBuffers/Lose.wav");
 }
 
 /*****************************************************************************************************************
@@ -182,24 +439,51 @@ void Game::loadSoundBuffers()
  *****************************************************************************************************************
  * Input: None																									 *
  * Output: None																									 *
- * Description: The function loads the game's fonts into the menu's resourceHolder instance for later use	     *
+ * Description: The function queues the game's fonts on the game's resourceHolder instance for later use	     *
  ****************************************************************************************************************/
 void Game::loadFonts()
 {
-	gameResourceHolder.loadFonts(Fonts::ID::Bauhaus, "Media/Fonts/Bauhaus93.ttf");
+	gameResourceHolder.queueFonts(Fonts::ID::Bauhaus, "Media/Fonts/Bauhaus93.ttf");
 }
 
 /*****************************************************************************************************************
- *										setBackgroundTile()														 *
+ *										loadBoard()																 *
  *****************************************************************************************************************
- * Input: None																									 *
+ * Input: Replay being played back, or nullptr																	 *
  * Output: None																									 *
- * Description: The function sets the bakcground tile texture used for the game board. This background tile      *
- * is a png image created specifically in a tile format where each tile is 32 x 32 pixels.						 *
+ * Description: The function reads the board from BOARD_MAP into the tile map, which draws it from the atlas,	 *
+ * and makes every cell the map does not let the snake walk on a wall of the GameCore, recording the walls in	 *
+ * the replay. A game playing a replay back takes the walls the replay was recorded with instead, so it plays	 *
+ * out the same if the map changed since. Throws a ResourceError if the map cannot be read, as a missing		 *
+ * texture would, or if it has a wall under the starting snake, which would die on its first tick.				 *
  ****************************************************************************************************************/
-void Game::setBackgroundTile()
+void Game::loadBoard(const Replay* replay)
 {
-	mBackgroundTile.setTexture(gameResourceHolder.getTextures(Textures::ID::Background));
+	mTileMap = std::unique_ptr<TileMap>(new TileMap(mTarget, gameResourceHolder.getTextures(Textures::ID::Atlas)));
+	if (!mTileMap->loadFromFile(BOARD_MAP))
+	{
+		throw ResourceError(Assets::Map, 0, std::string("Map 0 failed to load from ") + BOARD_MAP);
+	}
+	if (replay)
+	{
+		replay->addWallsTo(*mCore);
+		return;
+	}
+	for (int y = 0; y < std::min(mTileMap->getHeight(), mCore->getBoardHeight()); y++)
+	{
+		for (int x = 0; x < std::min(mTileMap->getWidth(), mCore->getBoardWidth()); x++)
+		{
+			if (!mTileMap->isWalkable(x, y))
+			{
+				if (isStartingCell(mCore->getBoardWidth(), mCore->getBoardHeight(), x, y))
+				{
+					throw ResourceError(Assets::Map, 0, std::string("Map 0 from ") + BOARD_MAP + " has a wall under the starting snake");
+				}
+				mCore->addWall(x, y);
+				mRecorder.addWall(x, y);
+			}
+		}
+	}
 }
 
 /*****************************************************************************************************************
@@ -207,12 +491,13 @@ void Game::setBackgroundTile()
  *****************************************************************************************************************
  * Input: None																									 *
  * Output: None																									 *
- * Description: The function renders the background image to the screen. This function must be called within     *
- * some type of game/render loop in order to render the background continuously to the screen.				     *
+ * Description: The function draws the board from the tile map, under everything else. This function must be	 *
+ * called within some type of game/render loop in order to render the background continuously.					 *
  ****************************************************************************************************************/
 void Game::renderBackground()
 {
-	mWindow.draw(mBackgroundTile);
+	ScopedTimer timer(Phase::ID::RenderBackground);
+	mTileMap->render();
 }
 
 
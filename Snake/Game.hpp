@@ -2,42 +2,81 @@
 #define GAME_HPP
 
 #include <memory>
+#include <string>
 
 #include <SFML/Graphics.hpp>
 
 #include "Food.hpp"
+#include "FramePacer.hpp"
+#include "FrameProfiler.hpp"
+#include "GameCore.hpp"
 #include "GameState.hpp"
+#include "Hud.hpp"
 #include "Menu.hpp"
-#include "ScoreBoard.hpp"
+#include "Policy.hpp"
+#include "ProfilerOverlay.hpp"
 #include "Snake.hpp"
+#include "Replay.hpp"
 #include "ResourceHolder.hpp"
+#include "SpriteBatch.hpp"
+#include "TileMap.hpp"
+
+// Most simulation ticks run in a single frame before the game gives up catching up
+#define MAX_CATCH_UP_TICKS 5
+// Rows at the top of the board covered by the score, where food is never placed
+#define HUD_ROWS 1
+// The board drawn under the game, with its walls
+#define BOARD_MAP "Media/Textures/SnakeBoard.tmx"
 
 class Game : public GameState
 {
 	public:
-											Game(sf::RenderWindow& window);
+											Game(sf::RenderWindow& window, unsigned int seed, sf::RenderTexture* offscreen = nullptr);
+											Game(sf::RenderWindow& window, const Replay& replay, sf::RenderTexture* offscreen = nullptr);
 		void								run();
+		bool								saveReplay(const std::string& filename) const;
+		void								setFramePacing(const FramePacing& pacing);
+		PacingStats							getPacingStats() const;
 
 	private:
+											Game(sf::RenderWindow& window, unsigned int seed, const Replay* replay, sf::RenderTexture* offscreen);
 		void								processEvents();
-		void								update(sf::Time deltaTime);
+		void								update();
 		void								render();
 		void								handlePlayerInput(sf::Keyboard::Key key, bool isPressed);
 		void								loadTextures();
 		void								loadSoundBuffers();
 		void								loadFonts();
-		void								setBackgroundTile();
+		void								loadBoard(const Replay* replay);
 		void								renderBackground();
-		
+		void								updateHud();
+
+		// Drives the game frame by frame to time processEvents(), update() and render() separately
+		friend class						ScenarioRunner;
 
 	private:
-		sf::Sprite							mBackgroundTile;
 		sf::RenderWindow&					mWindow;
+		sf::RenderTexture*					mOffscreen;
+		sf::RenderTarget&					mTarget;
 		ResourceHolder						gameResourceHolder;
+		std::unique_ptr<GameCore>			mCore;
+		Direction							mNextDirection;
+		unsigned long long					mTick;
+		ReplayRecorder						mRecorder;
+		std::unique_ptr<ReplayCursor>		mReplayInputs;
+		std::unique_ptr<Policy>				mAutopilot;
+		unsigned long long					mReplayTicks;
 		std::unique_ptr<Snake>				mSnake;
 		std::unique_ptr<Food>				mFood;
 		std::unique_ptr<Menu>				mMenu;
-		std::unique_ptr<ScoreBoard>			mScoreBoard;
+		std::unique_ptr<Hud>				mHud;
+		std::unique_ptr<SpriteBatch>		mSpriteBatch;
+		std::unique_ptr<TileMap>			mTileMap;
+		std::unique_ptr<ProfilerOverlay>	mProfilerOverlay;
+		FramePacer							mPacer;
+		bool								mFocused;
+		bool								mPaused;
+		bool								mDirty;
 
 };
 #endif
@@ -0,0 +1,491 @@
+#include "GameCore.hpp"
+
+#include <cassert>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value, "GameSnapshot must be copyable with memcpy");
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: int width and int height of the board in cells, unsigned int seed for the food placement				 *
+ * Output: None																									 *
+ * Description: The GameCore holds the complete rules of the game (the board, the snake, the food, the score and *
+ * the random number generator) without depending on SFML graphics, audio or a window. The Snake, Food and       *
+ * Hud classes are views that draw its state, and headless tools can run it directly. Two cores built            *
+ * with the same board and seed and given the same inputs play out identically.									 *
+ ****************************************************************************************************************/
+GameCore::GameCore(int boardWidth, int boardHeight, unsigned int seed) : hash(0), keys(&zobristKeys()), walled(false), random(seed)
+{
+	assert(isPlayableBoard(boardWidth, boardHeight));
+	food.x = 0;
+	food.y = 0;
+	occupied.resize(boardWidth, boardHeight);
+	foodExcluded.resize(boardWidth, boardHeight);
+	walls.resize(boardWidth, boardHeight);
+	reset();
+}
+
+/*****************************************************************************************************************
+ *										reset()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Starts a new game: the snake returns to its starting length, speed and direction in the center  *
+ * of the board and a new food location is generated. The random number generator is not reseeded, so a series  *
+ * of games stays reproducible from the original seed. The Zobrist hash is computed from scratch here and kept  *
+ * up to date by step() from then on.																			 *
+ ****************************************************************************************************************/
+void GameCore::reset()
+{
+	length = STARTING_LENGTH;
+	speed = STARTING_SPEED;
+	directionFacing = STARTING_DIRECTION;
+	gameOver = false;
+	tick = 0;
+	initializeBody();
+	generateNewFood();
+	hash = zobristHash(*this);
+}
+
+/*****************************************************************************************************************
+ *										initializeBody()														 *
+ *****************************************************************************************************************
+ * Input: None																								     *
+ * Output: None																									 *
+ * Description: Lays out a snake of length STARTING_LENGTH in the center of the board, facing right with its     *
+ * tail to the left. Only the cells of the previous body are released, so a reset costs the length of the old   *
+ * snake rather than the size of the board.																		 *
+ ****************************************************************************************************************/
+void GameCore::initializeBody()
+{
+	while (snakeBody.size() > 0)
+	{
+		Cell cell = snakeBody.popBack();
+		releaseCell(cell.x, cell.y);
+	}
+
+	for (int i = 0; i < STARTING_LENGTH; i++)
+	{
+		Cell cell = { static_cast<std::uint16_t>(occupied.getWidth() / 2 - i), static_cast<std::uint16_t>(occupied.getHeight() / 2) };
+		snakeBody.pushBack(cell);
+		occupyCell(cell.x, cell.y);
+	}
+}
+
+/*****************************************************************************************************************
+ *										excludeFromFood()														 *
+ *****************************************************************************************************************
+ * Input: int x and int y of a cell on the board																 *
+ * Output: None																									 *
+ * Description: Marks a cell where food must never be placed, such as the rows covered by the score. The snake   *
+ * can still move over the cell. If the current food lies on the cell, it is moved elsewhere.					 *
+ ****************************************************************************************************************/
+void GameCore::excludeFromFood(int x, int y)
+{
+	foodExcluded.set(x, y);
+	if (!gameOver && food.x == x && food.y == y && !generateNewFood())
+	{
+		gameOver = true;
+	}
+}
+
+/*****************************************************************************************************************
+ *										addWall()																 *
+ *****************************************************************************************************************
+ * Input: int x and int y of a cell on the board																 *
+ * Output: None																									 *
+ * Description: Makes a cell a wall, such as the cells of the board's tile map that are not walkable. The snake	 *
+ * dies moving into it, like moving off the board, and food is never placed on it. Walls are part of the board,	 *
+ * not of a game: reset() keeps them and snapshots do not hold them. The cell must not be one isStartingCell()	 *
+ * names.																										 *
+ ****************************************************************************************************************/
+void GameCore::addWall(int x, int y)
+{
+	assert(!isStartingCell(occupied.getWidth(), occupied.getHeight(), x, y));
+	walls.set(x, y);
+	walled = true;
+	excludeFromFood(x, y);
+}
+
+/*****************************************************************************************************************
+ *										occupyCell() / releaseCell()											 *
+ *****************************************************************************************************************
+ * Input: int x and int y of the cell the snake moves into / leaves												 *
+ * Output: None																									 *
+ * Description: Keep the occupancy grid up to date. The food is drawn from the grid itself, together with the	 *
+ * cells excluded from food, so nothing else has to follow the snake.											 *
+ ****************************************************************************************************************/
+void GameCore::occupyCell(int x, int y)
+{
+	occupied.set(x, y);
+}
+
+void GameCore::releaseCell(int x, int y)
+{
+	occupied.reset(x, y);
+}
+
+/*****************************************************************************************************************
+ *										snapshot() / restore()													 *
+ *****************************************************************************************************************
+ * Input: GameSnapshot to fill / to return to																	 *
+ * Output: None																									 *
+ * Description: Save and return to the complete state of a game, including the random number generator, so a	 *
+ * restored game continues exactly like the original. Search and rollback depend on this. The food is drawn		 *
+ * from the occupancy grid alone, so the grid, the body and a few counters are the whole state. Both are plain	 *
+ * memory copies; the body is copied only up to the length of the snake. A snapshot may only be restored into a	 *
+ * core with the same board, the same walls and the same cells excluded from food.								 *
+ ****************************************************************************************************************/
+void GameCore::snapshot(GameSnapshot& snapshot) const
+{
+	snapshot.length = length;
+	snapshot.direction = directionFacing;
+	snapshot.speed = speed;
+	snapshot.tick = tick;
+	snapshot.food = food;
+	snapshot.gameOver = gameOver;
+	snapshot.hash = hash;
+	snapshot.random = random;
+	snapshot.occupied = occupied;
+	snapshot.bodyCount = snakeBody.copyTo(snapshot.body);
+}
+
+void GameCore::restore(const GameSnapshot& snapshot)
+{
+	assert(snapshot.occupied.getWidth() == occupied.getWidth() && snapshot.occupied.getHeight() == occupied.getHeight());
+	length = snapshot.length;
+	directionFacing = static_cast<Direction>(snapshot.direction);
+	speed = snapshot.speed;
+	tick = snapshot.tick;
+	food = snapshot.food;
+	gameOver = snapshot.gameOver;
+	hash = snapshot.hash;
+	random = snapshot.random;
+	occupied = snapshot.occupied;
+	snakeBody.assign(snapshot.body, snapshot.bodyCount);
+}
+
+/*****************************************************************************************************************
+ *										step()   																 *
+ *****************************************************************************************************************
+ * Input: Direction the player wants to move in																	 *
+ * Output: int combination of GameEvent flags describing the tick												 *
+ * Description: Advances the game by one tick. The snake turns towards the input (turning back onto itself is    *
+ * ignored) and moves forward one cell. If the head lands on the food, the tail is kept in place so the snake    *
+ * grows by one, the snake speeds up and new food is generated. Running into a wall or into the body ends the    *
+ * game; the caller decides when to reset(). Every check is a single lookup in the occupancy grid and nothing is *
+ * allocated, so the cost of a tick does not depend on the snake's length. The Zobrist hash follows the turn,	 *
+ * the tail leaving, the head arriving and the food moving with a few XORs each.								 *
+ ****************************************************************************************************************/
+int GameCore::step(Direction input)
+{
+	if (gameOver)
+	{
+		return GameEvent::None;
+	}
+
+	tick++;
+	Direction facing = directionFacing;
+	changeDirection(input);
+	hash ^= keys->facing[facing] ^ keys->facing[directionFacing];
+
+	int x, y;
+	getNextHeadCell(x, y);
+	bool ateFood = (x == food.x && y == food.y);
+
+	// The tail leaves its cell on this step unless the snake is growing, so the head is free to move into it
+	if (!ateFood)
+	{
+		Cell tail = snakeBody.popBack();
+		hash ^= keys->link[tail.y * occupied.getWidth() + tail.x][directionBetween(tail, snakeBody.back())];
+		releaseCell(tail.x, tail.y);
+	}
+
+	if (collidesWithWall(x, y) || collidesWithSelf(x, y))
+	{
+		gameOver = true;
+		return GameEvent::Died;
+	}
+
+	Cell head = { static_cast<std::uint16_t>(x), static_cast<std::uint16_t>(y) };
+	int neck = snakeBody.front().y * occupied.getWidth() + snakeBody.front().x;
+	hash ^= keys->head[neck] ^ keys->link[neck][directionFacing] ^ keys->head[y * occupied.getWidth() + x];
+	snakeBody.pushFront(head);
+	occupyCell(x, y);
+
+	if (!ateFood)
+	{
+		return GameEvent::None;
+	}
+
+	length++;
+	speed += SPEED_BOOST;
+	if (!generateNewFood())
+	{
+		// The snake covers every cell food can be placed on, there is nowhere left to go
+		gameOver = true;
+		return GameEvent::AteFood | GameEvent::Won;
+	}
+	return GameEvent::AteFood;
+}
+
+/*****************************************************************************************************************
+ *										changeDirection()														 *
+ *****************************************************************************************************************
+ * Input: direction (Down, Up, Left, or Right)																	 *
+ * Output: None																								     *
+ * Description: Changes the direction the snake faces unless the new direction is the opposite of the current    *
+ * one, in which case the snake would self collide in a straight line.											 *
+ ****************************************************************************************************************/
+void GameCore::changeDirection(Direction direction)
+{
+	if ((directionFacing == Up && direction == Down) ||
+		(directionFacing == Down && direction == Up) ||
+		(directionFacing == Left && direction == Right) ||
+		(directionFacing == Right && direction == Left))
+	{
+		// Do nothing
+	}
+	else
+	{
+		directionFacing = direction;
+	}
+}
+
+/*****************************************************************************************************************
+ *										getNextHeadCell()														 *
+ *****************************************************************************************************************
+ * Input: int& x and int& y receiving the cell																	 *
+ * Output: None																									 *
+ * Description: Calculates the cell where the next head part should be located based on the direction that the  *
+ * snake is facing. The cell may lie off the board.																 *
+ ****************************************************************************************************************/
+void GameCore::getNextHeadCell(int& x, int& y) const
+{
+	x = snakeBody.front().x;
+	y = snakeBody.front().y;
+
+	if (directionFacing == Up)
+	{
+		y -= 1;
+	}
+	else if (directionFacing == Down)
+	{
+		y += 1;
+	}
+	else if (directionFacing == Right)
+	{
+		x += 1;
+	}
+	else if (directionFacing == Left)
+	{
+		x -= 1;
+	}
+}
+
+/*****************************************************************************************************************
+ *										generateNewFood()														 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: bool indicating if a free cell was found for the food												 *
+ * Description: Places the food on a random cell that is neither covered by the snake nor excluded from food.	 *
+ * One random number n picks the n-th such cell in board order, found by counting the free cells of the			 *
+ * occupancy grid a word of 64 cells at a time, so the cost is bounded by the size of the board at any fill		 *
+ * level. The cell depends on the grids and the generator alone, so a restored snapshot places food exactly as	 *
+ * the original game did. Returns false when there is no candidate left.										 *
+ ****************************************************************************************************************/
+bool GameCore::generateNewFood()
+{
+	int candidates = occupied.countFree(foodExcluded);
+	if (candidates == 0)
+	{
+		return false;
+	}
+
+	int cell = occupied.findFree(static_cast<int>(random.nextBelow(static_cast<std::uint32_t>(candidates))), foodExcluded);
+	hash ^= keys->food[food.y * occupied.getWidth() + food.x] ^ keys->food[cell];
+	food.x = static_cast<std::uint16_t>(cell % occupied.getWidth());
+	food.y = static_cast<std::uint16_t>(cell / occupied.getWidth());
+	return true;
+}
+
+/*****************************************************************************************************************
+ *										collidesWithSelf()													     *
+ *****************************************************************************************************************
+ * Input: int x and int y of the cell the head is about to move into											 *
+ * Output: Bool indicating true if the cell is covered by the snake												 *
+ * Description: Single lookup in the occupancy grid. The cell must already be known to lie on the board (see     *
+ * collidesWithWall).																							 *
+ ****************************************************************************************************************/
+bool GameCore::collidesWithSelf(int x, int y) const
+{
+	return occupied.test(x, y);
+}
+
+/*****************************************************************************************************************
+ *										collidesWithWall()														 *
+ *****************************************************************************************************************
+ * Input: int x and int y of the cell the head is about to move into											 *
+ * Output: bool indicating if the cell lies outside of the board or is a wall added with addWall()				 *
+ * Description: Anything outside of the board counts as a wall. The second lookup is skipped for cells off the	 *
+ * board, which the grid cannot test.																			 *
+ ****************************************************************************************************************/
+bool GameCore::collidesWithWall(int x, int y) const
+{
+	return !occupied.contains(x, y) || walls.test(x, y);
+}
+
+/*****************************************************************************************************************
+ *										isBlocked() / getBlocked()												 *
+ *****************************************************************************************************************
+ * Input: int x and int y of a cell / OccupancyGrid to fill														 *
+ * Output: bool indicating if the snake dies moving into the cell / None										 *
+ * Description: What the policies plan around: the cells off the board, the walls and the body. getBlocked()	 *
+ * fills a grid of the board with the walls and the body, for searches that test many cells. Like				 *
+ * collidesWithSelf(), neither knows that the tail moves away on the next tick.									 *
+ ****************************************************************************************************************/
+bool GameCore::isBlocked(int x, int y) const
+{
+	return collidesWithWall(x, y) || collidesWithSelf(x, y);
+}
+
+void GameCore::getBlocked(OccupancyGrid& blocked) const
+{
+	blocked = occupied;
+	blocked.merge(walls);
+}
+
+/*****************************************************************************************************************
+ *										Getters 																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: The requested part of the game state																	 *
+ * Description: Generic getter functions used by the views, the AI players and the headless tools. The score is  *
+ * the length of the snake minus STARTING_LENGTH so that every game starts at 0 points. The tick duration is the *
+ * time between two moves in seconds and shrinks as the snake speeds up. The hash is the Zobrist hash of the	 *
+ * position, equal to zobristHash(*this) for as long as the game is running. The walls are the cells added with	 *
+ * addWall(), kept apart from the body.																			 *
+ ****************************************************************************************************************/
+bool GameCore::isGameOver() const
+{
+	return gameOver;
+}
+
+const SnakeBody& GameCore::getBody() const
+{
+	return snakeBody;
+}
+
+const OccupancyGrid& GameCore::getOccupied() const
+{
+	return occupied;
+}
+
+const OccupancyGrid& GameCore::getWalls() const
+{
+	return walls;
+}
+
+bool GameCore::hasWalls() const
+{
+	return walled;
+}
+
+Cell GameCore::getFood() const
+{
+	return food;
+}
+
+Direction GameCore::getDirection() const
+{
+	return directionFacing;
+}
+
+int GameCore::getLength() const
+{
+	return length;
+}
+
+int GameCore::getScore() const
+{
+	return length - STARTING_LENGTH;
+}
+
+double GameCore::getSpeed() const
+{
+	return speed;
+}
+
+double GameCore::getTickDuration() const
+{
+	return SPEED_RATE / speed;
+}
+
+unsigned long long GameCore::getTick() const
+{
+	return tick;
+}
+
+std::uint64_t GameCore::getHash() const
+{
+	return hash;
+}
+
+int GameCore::getBoardWidth() const
+{
+	return occupied.getWidth();
+}
+
+int GameCore::getBoardHeight() const
+{
+	return occupied.getHeight();
+}
+
+/*****************************************************************************************************************
+ *										directionBetween()														 *
+ *****************************************************************************************************************
+ * Input: Cell from and Cell to, next to each other																 *
+ * Output: Direction of the move from one cell to the other														 *
+ * Description: Used to name the link between two neighboring body segments.									 *
+ ****************************************************************************************************************/
+Direction directionBetween(Cell from, Cell to)
+{
+	if (to.x > from.x)
+	{
+		return Right;
+	}
+	if (to.x < from.x)
+	{
+		return Left;
+	}
+	return (to.y > from.y) ? Down : Up;
+}
+
+/*****************************************************************************************************************
+ *										isPlayableBoard()														 *
+ *****************************************************************************************************************
+ * Input: int width and int height of a board in cells															 *
+ * Output: bool indicating if a GameCore can play on the board													 *
+ * Description: The board must be at least MIN_BOARD_WIDTH wide for the starting snake to fit and must fit in	 *
+ * MAX_BOARD_CELLS. Every tool that takes a board size from the user or from a file checks it here before		 *
+ * building a GameCore.																							 *
+ ****************************************************************************************************************/
+bool isPlayableBoard(int width, int height)
+{
+	return width >= MIN_BOARD_WIDTH && height >= 1 && width * height <= MAX_BOARD_CELLS;
+}
+
+/*****************************************************************************************************************
+ *										isStartingCell()														 *
+ *****************************************************************************************************************
+ * Input: int width and int height of a board in cells, int x and int y of a cell on it							 *
+ * Output: bool indicating if the snake starts on the cell														 *
+ * Description: The starting snake lies in the center row, its head in the center column and its tail			 *
+ * STARTING_LENGTH - 1 cells to the left. A wall on one of these cells would kill the snake on its first tick,	 *
+ * so the map and replay loaders reject it.																		 *
+ ****************************************************************************************************************/
+bool isStartingCell(int width, int height, int x, int y)
+{
+	return y == height / 2 && x <= width / 2 && x > width / 2 - STARTING_LENGTH;
+}
@@ -0,0 +1,100 @@
+#ifndef GAMECORE_HPP
+#define GAMECORE_HPP
+
+#include "OccupancyGrid.hpp"
+#include "Random.hpp"
+#include "SnakeBody.hpp"
+#include "Zobrist.hpp"
+
+#define SPEED_RATE 0.3
+#define SPEED_BOOST 0.2
+#define STARTING_DIRECTION Right
+#define STARTING_LENGTH 3
+#define STARTING_SPEED 1
+// Narrowest board the starting snake fits on: it lies to the left of the center, STARTING_LENGTH - 1 cells long
+#define MIN_BOARD_WIDTH (2 * (STARTING_LENGTH - 1))
+
+enum Direction { Down, Left, Right, Up };
+
+Direction						directionBetween(Cell from, Cell to);
+bool							isPlayableBoard(int width, int height);
+bool							isStartingCell(int width, int height, int x, int y);
+
+// step() reports what happened during a tick as a combination of these flags
+namespace GameEvent
+{
+	enum Type { None = 0, AteFood = 1 << 0, Died = 1 << 1, Won = 1 << 2 };
+}
+
+// Everything about a game that changes while it is played, as one trivially copyable block. Only the first
+// bodyCount cells of the body are meaningful, and only those are copied
+struct GameSnapshot
+{
+	std::int32_t			length;
+	std::int32_t			direction;
+	double					speed;
+	unsigned long long		tick;
+	Cell					food;
+	bool					gameOver;
+	std::uint64_t			hash;
+	Random					random;
+	OccupancyGrid			occupied;
+	std::int32_t			bodyCount;
+	Cell					body[MAX_BOARD_CELLS];
+};
+
+class GameCore
+{
+	public:
+								GameCore(int boardWidth, int boardHeight, unsigned int seed);
+		void					reset();
+		void					excludeFromFood(int x, int y);
+		void					addWall(int x, int y);
+		void					snapshot(GameSnapshot& snapshot) const;
+		void					restore(const GameSnapshot& snapshot);
+		int						step(Direction input);
+		bool					collidesWithSelf(int x, int y) const;
+		bool					collidesWithWall(int x, int y) const;
+		bool					isBlocked(int x, int y) const;
+		bool					hasWalls() const;
+		void					getBlocked(OccupancyGrid& blocked) const;
+		bool					isGameOver() const;
+		const SnakeBody&		getBody() const;
+		const OccupancyGrid&	getOccupied() const;
+		const OccupancyGrid&	getWalls() const;
+		Cell					getFood() const;
+		Direction				getDirection() const;
+		int						getLength() const;
+		int						getScore() const;
+		double					getSpeed() const;
+		double					getTickDuration() const;
+		unsigned long long		getTick() const;
+		std::uint64_t			getHash() const;
+		int						getBoardWidth() const;
+		int						getBoardHeight() const;
+
+	private:
+		void					initializeBody();
+		void					changeDirection(Direction direction);
+		void					getNextHeadCell(int& x, int& y) const;
+		bool					generateNewFood();
+		void					occupyCell(int x, int y);
+		void					releaseCell(int x, int y);
+
+	private:
+		int						length;
+		double					speed;
+		Direction				directionFacing;
+		Cell					food;
+		bool					gameOver;
+		unsigned long long		tick;
+		std::uint64_t			hash;
+		const ZobristKeys*		keys;
+		SnakeBody				snakeBody;
+		OccupancyGrid			occupied;
+		OccupancyGrid			foodExcluded;
+		OccupancyGrid			walls;
+		bool					walled;
+		Random					random;
+};
+#endif
@@ -0,0 +1,266 @@
+#include "Hamilton.hpp"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	std::mutex cacheMutex;
+	std::vector<std::unique_ptr<HamiltonCycle>> cache;
+}
+
+/*****************************************************************************************************************
+ *										forBoard()																 *
+ *****************************************************************************************************************
+ * Input: int width and int height of the board in cells														 *
+ * Output: const HamiltonCycle* for the board, or nullptr when the board has no Hamiltonian cycle				 *
+ * Description: Returns the cycle of a board size, building it on first use. Cycles live for the rest of the	 *
+ * program, so every game and every thread on the same board size shares one. A board with an odd number of    *
+ * cells has no cycle, since moves alternate between the two colors of a checkerboard.							 *
+ ****************************************************************************************************************/
+const HamiltonCycle* HamiltonCycle::forBoard(int width, int height)
+{
+	if ((width % 2 != 0 && height % 2 != 0) || width < 2 || height < 2 || width * height > MAX_BOARD_CELLS)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	for (const std::unique_ptr<HamiltonCycle>& cycle : cache)
+	{
+		if (cycle->width == width && cycle->height == height)
+		{
+			return cycle.get();
+		}
+	}
+	cache.push_back(std::unique_ptr<HamiltonCycle>(new HamiltonCycle(width, height)));
+	return cache.back().get();
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: int width and int height of the board, at least one of them even										 *
+ * Output: None																									 *
+ * Description: Lays the cycle out as rows swept back and forth over every column but the first, with the first *
+ * column as the way back to the start:																			 *
+ *   row 0 runs right from column 0, the following rows alternate left and right over columns 1 to width - 1,   *
+ *   and the last row ends next to column 0, which leads back up to row 0.										 *
+ * This needs an even number of rows, so a board with an odd height is swept by columns instead. The cycle is	 *
+ * stored as the position of every cell along it and the cell that follows it, so both lookups are O(1).		 *
+ ****************************************************************************************************************/
+HamiltonCycle::HamiltonCycle(int width, int height) : width(width), height(height)
+{
+	bool byColumns = (height % 2 != 0);
+	int lines = byColumns ? width : height;
+	int lineLength = byColumns ? height : width;
+
+	std::vector<int> path;
+	path.reserve(static_cast<std::size_t>(width * height));
+	for (int line = 0; line < lines; line++)
+	{
+		for (int i = 1; i < lineLength; i++)
+		{
+			int along = (line % 2 == 0) ? i : lineLength - i;
+			if (line == 0 && i == 1)
+			{
+				path.push_back(0);
+			}
+			path.push_back(byColumns ? along * width + line : line * width + along);
+		}
+	}
+	for (int line = lines - 1; line > 0; line--)
+	{
+		path.push_back(byColumns ? line : line * width);
+	}
+
+	for (std::size_t i = 0; i < path.size(); i++)
+	{
+		order[path[i]] = static_cast<std::uint16_t>(i);
+		next[path[i]] = static_cast<std::uint16_t>(path[(i + 1) % path.size()]);
+	}
+}
+
+/*****************************************************************************************************************
+ *										Getters 																 *
+ *****************************************************************************************************************
+ * Input: int cell index (y * width + x)																		 *
+ * Output: Position of the cell along the cycle, the cell after it, or the board size							 *
+ * Description: Generic getter functions for the cycle.															 *
+ ****************************************************************************************************************/
+int HamiltonCycle::getOrder(int cell) const
+{
+	return order[cell];
+}
+
+int HamiltonCycle::getNext(int cell) const
+{
+	return next[cell];
+}
+
+int HamiltonCycle::getCellCount() const
+{
+	return width * height;
+}
+
+/*****************************************************************************************************************
+ *										distance()																 *
+ *****************************************************************************************************************
+ * Input: int from and int to cell indices																		 *
+ * Output: int number of steps along the cycle from one cell to the other										 *
+ * Description: Distances are measured forward only, so distance(a, b) + distance(b, a) is the board size.		 *
+ ****************************************************************************************************************/
+int HamiltonCycle::distance(int from, int to) const
+{
+	int steps = order[to] - order[from];
+	return (steps < 0) ? steps + width * height : steps;
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: HamiltonPolicy fills the whole board by following a Hamiltonian cycle, cutting across it while  *
+ * that is safe. Boards without a cycle are left to the autopilot.												 *
+ ****************************************************************************************************************/
+HamiltonPolicy::HamiltonPolicy() : cycle(nullptr), width(0), height(0), onCycle(false), lastTick(0)
+{
+}
+
+/*****************************************************************************************************************
+ *										reset()																	 *
+ *****************************************************************************************************************
+ * Input: unsigned int seed, passed on to the fallback															 *
+ * Output: None																									 *
+ * Description: Forgets whether the snake followed the cycle, so the next decision checks the body again. The	 *
+ * cycle of the board is kept.																					 *
+ ****************************************************************************************************************/
+void HamiltonPolicy::reset(unsigned int seed)
+{
+	onCycle = false;
+	fallback.reset(seed);
+}
+
+/*****************************************************************************************************************
+ *										decide()																 *
+ *****************************************************************************************************************
+ * Input: GameCore to drive																						 *
+ * Output: Direction for the next tick																			 *
+ * Description: While the body lies along the cycle in order, from the tail forward to the head, every cell		 *
+ * ahead of the head up to the tail is free. Moving the head to any of them keeps the body in order, and the	 *
+ * next cell along the cycle is then always free or the tail that is about to leave, so the snake can never	 *
+ * trap itself. Each tick it takes the neighbor that lies furthest along the cycle without passing the tail or  *
+ * the food, which is the next cell of the cycle when no shortcut applies. That is four lookups per tick.		 *
+ * A snake that does not lie along the cycle yet (after a reset on a board swept by columns, for instance)		 *
+ * follows the cycle where it can and any safe move where it cannot, until it does.								 *
+ * A cycle runs through every cell, walls included, so a board with walls is left to the fallback policy.		 *
+ ****************************************************************************************************************/
+Direction HamiltonPolicy::decide(const GameCore& core)
+{
+	if (cycle == nullptr || width != core.getBoardWidth() || height != core.getBoardHeight())
+	{
+		width = core.getBoardWidth();
+		height = core.getBoardHeight();
+		cycle = HamiltonCycle::forBoard(width, height);
+		onCycle = false;
+	}
+	if (cycle == nullptr || core.hasWalls())
+	{
+		return fallback.decide(core);
+	}
+
+	// A new game, or a core the policy has not been driving, has to be checked again
+	if (core.getTick() != lastTick + 1)
+	{
+		onCycle = false;
+	}
+	lastTick = core.getTick();
+	if (!onCycle)
+	{
+		onCycle = bodyFollowsCycle(core);
+	}
+
+	int head = toIndex(core.getBody().front());
+	int next = cycle->getNext(head);
+	if (!onCycle)
+	{
+		Direction direction = directionTo(head, next);
+		if (isSafeMove(core, direction))
+		{
+			return direction;
+		}
+		for (Direction other : { Down, Left, Right, Up })
+		{
+			if (isSafeMove(core, other))
+			{
+				return other;
+			}
+		}
+		return direction;
+	}
+
+	int tailDistance = cycle->distance(head, toIndex(core.getBody().back()));
+	int foodDistance = cycle->distance(head, toIndex(core.getFood()));
+	int bestDistance = 1;
+	Cell cell = core.getBody().front();
+	const int neighbors[4] = { cell.y + 1 < height ? head + width : -1, cell.x > 0 ? head - 1 : -1,
+		cell.x + 1 < width ? head + 1 : -1, cell.y > 0 ? head - width : -1 };
+	for (int neighbor : neighbors)
+	{
+		if (neighbor < 0)
+		{
+			continue;
+		}
+		int distance = cycle->distance(head, neighbor);
+		if (distance > bestDistance && distance < tailDistance && distance <= foodDistance)
+		{
+			next = neighbor;
+			bestDistance = distance;
+		}
+	}
+	return directionTo(head, next);
+}
+
+/*****************************************************************************************************************
+ *										bodyFollowsCycle()														 *
+ *****************************************************************************************************************
+ * Input: GameCore being driven																					 *
+ * Output: bool true if going from the tail to the head the body only ever moves forward along the cycle		 *
+ * Description: Takes the length of the snake, so it only runs until the body first lies along the cycle.		 *
+ ****************************************************************************************************************/
+bool HamiltonPolicy::bodyFollowsCycle(const GameCore& core) const
+{
+	const SnakeBody& body = core.getBody();
+	int tail = toIndex(body.back());
+	int previous = 0;
+	for (int i = body.size() - 2; i >= 0; i--)
+	{
+		int distance = cycle->distance(tail, toIndex(body[i]));
+		if (distance <= previous)
+		{
+			return false;
+		}
+		previous = distance;
+	}
+	return true;
+}
+
+Direction HamiltonPolicy::directionTo(int from, int to) const
+{
+	if (to == from + 1)
+	{
+		return Right;
+	}
+	if (to == from - 1)
+	{
+		return Left;
+	}
+	return (to > from) ? Down : Up;
+}
+
+int HamiltonPolicy::toIndex(Cell cell) const
+{
+	return cell.y * width + cell.x;
+}
@@ -0,0 +1,50 @@
+#ifndef HAMILTON_HPP
+#define HAMILTON_HPP
+
+#include <cstdint>
+
+#include "Autopilot.hpp"
+#include "GameCore.hpp"
+#include "Policy.hpp"
+
+// A closed path through every cell of a board, built once per board size and shared by every game on that size
+class HamiltonCycle
+{
+	public:
+		static const HamiltonCycle*	forBoard(int width, int height);
+		int							getOrder(int cell) const;
+		int							getNext(int cell) const;
+		int							distance(int from, int to) const;
+		int							getCellCount() const;
+
+	private:
+									HamiltonCycle(int width, int height);
+
+	private:
+		int							width;
+		int							height;
+		std::uint16_t				order[MAX_BOARD_CELLS];
+		std::uint16_t				next[MAX_BOARD_CELLS];
+};
+
+class HamiltonPolicy : public Policy
+{
+	public:
+									HamiltonPolicy();
+		Direction					decide(const GameCore& core);
+		void						reset(unsigned int seed);
+
+	private:
+		bool						bodyFollowsCycle(const GameCore& core) const;
+		Direction					directionTo(int from, int to) const;
+		int							toIndex(Cell cell) const;
+
+	private:
+		const HamiltonCycle*		cycle;
+		AutopilotPolicy				fallback;
+		int							width;
+		int							height;
+		bool						onCycle;
+		unsigned long long			lastTick;
+};
+#endif
@@ -0,0 +1,204 @@
+#include "Hud.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "FrameProfiler.hpp"
+
+namespace
+{
+	// Label and left edge in pixels of every readout, in the order of Readout::ID
+	const char* const labels[Readout::Count] = { "SCORE ", "LENGTH ", "SPEED ", "FPS " };
+	const float labelLeft[Readout::Count] = { 0.0f, 260.0f, 520.0f, 780.0f };
+	const char* const digits = "0123456789";
+	const int largestValue = 9999999;
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: sf::Texture of the atlas, whose glyph region the HUD fills, sf::Font of the text						 *
+ * Output: None																									 *
+ * Description: Bakes the glyphs, sizes the vertex array for every label character and HUD_DIGITS digits	 *
+ * per readout, which is the only allocation the HUD makes, and lays out the labels and a value of 0 for every	 *
+ * readout.																										 *
+ ****************************************************************************************************************/
+Hud::Hud(sf::Texture& atlas, const sf::Font& font) : atlas(atlas), vertices(sf::Quads)
+{
+	bakeGlyphs(font);
+
+	int quads = 0;
+	for (int readout = 0; readout < Readout::Count; readout++)
+	{
+		quads += static_cast<int>(std::strlen(labels[readout])) + HUD_DIGITS;
+	}
+	vertices.resize(quads * 4);
+
+	int quad = 0;
+	for (int readout = 0; readout < Readout::Count; readout++)
+	{
+		valueLeft[readout] = layoutText(labels[readout], labelLeft[readout], quad);
+		quad += static_cast<int>(std::strlen(labels[readout]));
+		valueFirstQuad[readout] = quad;
+		quad += HUD_DIGITS;
+
+		values[readout] = 0;
+		layoutValue(static_cast<Readout::ID>(readout));
+	}
+}
+
+/*****************************************************************************************************************
+ *										setValue()																 *
+ *****************************************************************************************************************
+ * Input: Readout::ID to set, int value (negative values show as 0)												 *
+ * Output: bool indicating if the value changed, and with it the picture										 *
+ * Description: Cheap enough to call every tick: an unchanged value returns right away.							 *
+ ****************************************************************************************************************/
+bool Hud::setValue(Readout::ID readout, int value)
+{
+	if (values[readout] == value)
+	{
+		return false;
+	}
+	values[readout] = value;
+	layoutValue(readout);
+	return true;
+}
+
+int Hud::getValue(Readout::ID readout) const
+{
+	return values[readout];
+}
+
+/*****************************************************************************************************************
+ *										render()																 *
+ *****************************************************************************************************************
+ * Input: SpriteBatch of the frame																				 *
+ * Output: None																									 *
+ * Description: Adds the quads of the whole row to the batch, which draws them with the rest of the atlas.		 *
+ ****************************************************************************************************************/
+void Hud::render(SpriteBatch& spriteBatch)
+{
+	ScopedTimer timer(Phase::ID::RenderHud);
+	spriteBatch.addQuads(vertices);
+}
+
+/*****************************************************************************************************************
+ *										bakeGlyphs()															 *
+ *****************************************************************************************************************
+ * Input: sf::Font to take the glyphs from																		 *
+ * Output: None																									 *
+ * Description: Renders the digits and the characters of the labels at HUD_CHARACTER_SIZE and copies them side	 *
+ * by side into the glyph region of the atlas. Every glyph is requested before the font's page is copied, since	 *
+ * a new glyph can make the font grow its page. Characters without pixels, such as the space, only keep their	 *
+ * advance, and so do glyphs that no longer fit in the region.													 *
+ ****************************************************************************************************************/
+void Hud::bakeGlyphs(const sf::Font& font)
+{
+	bool wanted[HUD_GLYPHS] = {};
+	for (const char* character = digits; *character != '\0'; character++)
+	{
+		wanted[static_cast<unsigned char>(*character)] = true;
+	}
+	for (int readout = 0; readout < Readout::Count; readout++)
+	{
+		for (const char* character = labels[readout]; *character != '\0'; character++)
+		{
+			wanted[static_cast<unsigned char>(*character)] = true;
+		}
+	}
+	for (int code = 0; code < HUD_GLYPHS; code++)
+	{
+		if (wanted[code])
+		{
+			font.getGlyph(code, HUD_CHARACTER_SIZE, false);
+		}
+	}
+
+	const AtlasRect& region = atlasRegions[AtlasRegion::ID::Glyphs];
+	sf::Image page = font.getTexture(HUD_CHARACTER_SIZE).copyToImage();
+	sf::Image image;
+	image.create(region.width, region.height, sf::Color::Transparent);
+
+	int left = 0;
+	for (int code = 0; code < HUD_GLYPHS; code++)
+	{
+		glyphs[code].bounds = sf::FloatRect();
+		glyphs[code].atlasRect = sf::IntRect();
+		glyphs[code].advance = 0.0f;
+		if (!wanted[code])
+		{
+			continue;
+		}
+
+		const sf::Glyph& glyph = font.getGlyph(code, HUD_CHARACTER_SIZE, false);
+		glyphs[code].bounds = glyph.bounds;
+		glyphs[code].advance = glyph.advance;
+		if (glyph.textureRect.width > 0 && glyph.textureRect.height > 0 && left + glyph.textureRect.width <= region.width &&
+			glyph.textureRect.height <= region.height)
+		{
+			image.copy(page, left, 0, glyph.textureRect);
+			glyphs[code].atlasRect = sf::IntRect(region.left + left, region.top, glyph.textureRect.width, glyph.textureRect.height);
+			left += glyph.textureRect.width + 1;
+		}
+	}
+	atlas.update(image, region.left, region.top);
+}
+
+/*****************************************************************************************************************
+ *										layoutText()															 *
+ *****************************************************************************************************************
+ * Input: text to lay out, left edge of the text in pixels, first quad of the vertex array it uses				 *
+ * Output: float left edge of whatever follows the text															 *
+ * Description: Places one quad per character on the HUD baseline.												 *
+ ****************************************************************************************************************/
+float Hud::layoutText(const char* text, float left, int firstQuad)
+{
+	for (int i = 0; text[i] != '\0'; i++)
+	{
+		const Glyph& glyph = glyphs[static_cast<unsigned char>(text[i]) % HUD_GLYPHS];
+		sf::Vertex* quad = &vertices[(firstQuad + i) * 4];
+		float x = left + glyph.bounds.left;
+		float y = HUD_BASELINE + glyph.bounds.top;
+		float u = static_cast<float>(glyph.atlasRect.left);
+		float v = static_cast<float>(glyph.atlasRect.top);
+		float width = static_cast<float>(glyph.atlasRect.width);
+		float height = static_cast<float>(glyph.atlasRect.height);
+
+		quad[0] = sf::Vertex(sf::Vector2f(x, y), sf::Vector2f(u, v));
+		quad[1] = sf::Vertex(sf::Vector2f(x + width, y), sf::Vector2f(u + width, v));
+		quad[2] = sf::Vertex(sf::Vector2f(x + width, y + height), sf::Vector2f(u + width, v + height));
+		quad[3] = sf::Vertex(sf::Vector2f(x, y + height), sf::Vector2f(u, v + height));
+		left += glyph.advance;
+	}
+	return left;
+}
+
+/*****************************************************************************************************************
+ *										layoutValue()															 *
+ *****************************************************************************************************************
+ * Input: Readout::ID whose value changed																		 *
+ * Output: None																									 *
+ * Description: Writes the digits of the value into a buffer on the stack, without std::to_string, lays them out *
+ * after the label and collapses the digit quads the value does not use.										 *
+ ****************************************************************************************************************/
+void Hud::layoutValue(Readout::ID readout)
+{
+	char text[HUD_DIGITS + 1];
+	int value = std::min(std::max(values[readout], 0), largestValue);
+	int count = 0;
+	do
+	{
+		text[count++] = digits[value % 10];
+		value /= 10;
+	} while (value > 0);
+	std::reverse(text, text + count);
+	text[count] = '\0';
+
+	layoutText(text, valueLeft[readout], valueFirstQuad[readout]);
+	for (int i = count; i < HUD_DIGITS; i++)
+	{
+		sf::Vertex* quad = &vertices[(valueFirstQuad[readout] + i) * 4];
+		quad[0] = quad[1] = quad[2] = quad[3] = sf::Vertex();
+	}
+}
@@ -0,0 +1,54 @@
+#ifndef HUD_HPP
+#define HUD_HPP
+
+#include <SFML/Graphics.hpp>
+
+#include "SpriteBatch.hpp"
+
+// Character size of the HUD text, and the baseline of its row in pixels
+#define HUD_CHARACTER_SIZE 30
+#define HUD_BASELINE 26
+// Most digits a readout shows, larger values are clamped to all nines
+#define HUD_DIGITS 7
+// Characters the HUD can show, indexed by their ASCII code
+#define HUD_GLYPHS 128
+
+namespace Readout
+{
+	enum ID { Score, Length, Speed, Fps, Count };
+}
+
+// The text of the top row. The digits and the letters of the labels are copied out of the Bauhaus font once, into
+// the glyph region of the atlas, and every character of the row is a quad of one vertex array over that region. The
+// labels are laid out once; a readout only rewrites its own quads when its value changes. Setting a value never
+// allocates, and the row goes into the sprite batch with the rest of the scene
+class Hud
+{
+	public:
+								Hud(sf::Texture& atlas, const sf::Font& font);
+		bool					setValue(Readout::ID readout, int value);
+		int						getValue(Readout::ID readout) const;
+		void					render(SpriteBatch& spriteBatch);
+
+	private:
+		struct Glyph
+		{
+			sf::FloatRect		bounds;
+			sf::IntRect			atlasRect;
+			float				advance;
+		};
+
+	private:
+		void					bakeGlyphs(const sf::Font& font);
+		float					layoutText(const char* text, float left, int firstQuad);
+		void					layoutValue(Readout::ID readout);
+
+	private:
+		sf::Texture&			atlas;
+		Glyph					glyphs[HUD_GLYPHS];
+		sf::VertexArray			vertices;
+		int						values[Readout::Count];
+		float					valueLeft[Readout::Count];
+		int						valueFirstQuad[Readout::Count];
+};
+#endif
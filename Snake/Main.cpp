@@ -1,18 +1,185 @@
 #include "Game.hpp"
 #include <stdlib.h>
 #include <time.h>
+#include <iostream>
 #include <memory>
+#include <string>
 #include <SFML/Graphics.hpp>
 
-int main()
+// Every session is saved here when the window is closed
+#define LAST_REPLAY_FILE "LastGame.replay"
+// Frame profile written on exit when the profiler ran (F3 or --profile) and no other file was given
+#define LAST_PROFILE_FILE "LastGame.profile.json"
+
+/*****************************************************************************************************************
+ *										saveProfile()															 *
+ *****************************************************************************************************************
+ * Input: std::string& indicating the file the frame profile is written to										 *
+ * Output: None																									 *
+ * Description: Writes the frame profile, if any frame was profiled, and reports a file that could not be		 *
+ * written. JSON or CSV is picked by FrameProfiler::save() from the extension.									 *
+ ****************************************************************************************************************/
+static void saveProfile(const std::string& filename)
+{
+	if (FrameProfiler::instance().getFrameCount() > 0 && !FrameProfiler::instance().save(filename))
+	{
+		std::cerr << "Could not write " << filename << std::endl;
+	}
+}
+
+/*****************************************************************************************************************
+ *										printPacing()															 *
+ *****************************************************************************************************************
+ * Input: std::string& naming the loop, PacingStats of the loop													 *
+ * Output: None																									 *
+ * Description: Reports how evenly the loop's frames came, how many of them were presented and how busy the		 *
+ * loop kept the processor.																						 *
+ ****************************************************************************************************************/
+static void printPacing(const std::string& loop, const PacingStats& stats)
 {
-	srand(time(0));
+	std::cout << loop << ": " << stats.frames << " frames, " << stats.presentedFrames << " presented, " << stats.meanIntervalMs << " ms apart, jitter " << stats.jitterMs
+		<< " ms, longest " << stats.longestIntervalMs << " ms, CPU " << stats.cpuPercent << "%\n";
+}
+
+// Usage: Snake [--replay file] [--profile file.json|file.csv] [--trace file.json] [--vsync] [--fps N] [--idle-fps N]
+//              [--pack file | --loose]
+// --fps 0 runs as fast as possible. Assets come from Media.pack when it is there, and from Media/ otherwise or with --loose
+int main(int argc, char* argv[])
+{
+	std::string replayFile;
+	std::string packFile;
+	bool looseFiles = false;
+	std::string profileFile = LAST_PROFILE_FILE;
+	FramePacing pacing = FramePacer::defaultFramePacing();
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--vsync")
+		{
+			pacing.vsync = true;
+			continue;
+		}
+		if (option == "--loose")
+		{
+			looseFiles = true;
+			continue;
+		}
+		if (i + 1 == argc)
+		{
+			std::cerr << option << " needs a value" << std::endl;
+			return 1;
+		}
+
+		std::string value = argv[++i];
+		if (option == "--replay")
+		{
+			replayFile = value;
+		}
+		else if (option == "--profile")
+		{
+			profileFile = value;
+			FrameProfiler::setEnabled(true);
+		}
+		else if (option == "--trace")
+		{
+			if (!Trace::start(value))
+			{
+				std::cerr << "Could not write " << value << std::endl;
+				return 1;
+			}
+			Trace::setThreadName("main");
+		}
+		else if (option == "--pack")
+		{
+			packFile = value;
+		}
+		else if (option == "--fps")
+		{
+			pacing.targetFps = atoi(value.c_str());
+		}
+		else if (option == "--idle-fps")
+		{
+			pacing.idleFps = atoi(value.c_str());
+		}
+		else
+		{
+			std::cerr << "Unknown option " << option << std::endl;
+			std::cerr << "Usage: Snake [--replay file] [--profile file.json|file.csv] [--trace file.json] [--vsync] [--fps N] [--idle-fps N] "
+				"[--pack file | --loose]" << std::endl;
+			Trace::stop();
+			return 1;
+		}
+	}
+
+	// Stays open for the whole run: music and fonts are read from the mapped pack while they are in use
+	AssetPack assetPack;
+	if (!looseFiles && assetPack.open(packFile.empty() ? PACK_FILE : packFile))
+	{
+		ResourceHolder::setAssetPack(&assetPack);
+	}
+	else if (!looseFiles && !packFile.empty())
+	{
+		std::cerr << packFile << " is not an asset pack" << std::endl;
+		Trace::stop();
+		return 1;
+	}
+
 	sf::RenderWindow window(sf::VideoMode(1024, 896, 32), "Snake");
-	std::unique_ptr<GameState> game(new Game(window));
-	std::unique_ptr<GameState> menu(new Menu(window));
+
+	if (!replayFile.empty())
+	{
+		Replay replay;
+		if (!replay.open(replayFile) || replay.getHeader().boardWidth != window.getSize().x / BODY_DIMENSIONS ||
+			replay.getHeader().boardHeight != window.getSize().y / BODY_DIMENSIONS || replay.getHeader().hudRows != HUD_ROWS)
+		{
+			std::cerr << replayFile << " is not a replay of this game" << std::endl;
+			Trace::stop();
+			return 1;
+		}
+
+		std::unique_ptr<Game> game;
+		try
+		{
+			game = std::unique_ptr<Game>(new Game(window, replay));
+		}
+		catch (const ResourceError& error)
+		{
+			std::cerr << error.what() << std::endl;
+			Trace::stop();
+			return 1;
+		}
+		game->setFramePacing(pacing);
+		game->run();
+		printPacing("Game", game->getPacingStats());
+		saveProfile(profileFile);
+		Trace::stop();
+		return 0;
+	}
+
+	// An asset that did not load stops the game here, naming the file, rather than when it is first drawn
+	std::unique_ptr<Game> game;
+	std::unique_ptr<Menu> menu;
+	try
+	{
+		game = std::unique_ptr<Game>(new Game(window, static_cast<unsigned int>(time(0))));
+		menu = std::unique_ptr<Menu>(new Menu(window));
+	}
+	catch (const ResourceError& error)
+	{
+		std::cerr << error.what() << std::endl;
+		Trace::stop();
+		return 1;
+	}
+	game->setFramePacing(pacing);
+	menu->setFramePacing(pacing);
 
 	menu->run();
 	game->run();
+	game->saveReplay(LAST_REPLAY_FILE);
+	printPacing("Menu", menu->getPacingStats());
+	printPacing("Game", game->getPacingStats());
+	saveProfile(profileFile);
+	Trace::stop();
 
 	return 0;
-}
\ No newline at end of file
+}
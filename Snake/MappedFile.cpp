@@ -0,0 +1,160 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+/*****************************************************************************************************************
+ *										Constructor / Destructor												 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: A MappedFile maps a whole file read only into memory, so its bytes can be used in place without  *
+ * reading or parsing them into buffers first. The operating system pages the file in on demand and shares the   *
+ * pages between processes. The destructor unmaps the file.														 *
+ ****************************************************************************************************************/
+#ifdef _WIN32
+MappedFile::MappedFile() : data(nullptr), size(0), file(INVALID_HANDLE_VALUE), mapping(nullptr)
+{
+}
+#else
+MappedFile::MappedFile() : data(nullptr), size(0)
+{
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+/*****************************************************************************************************************
+ *										open()   																 *
+ *****************************************************************************************************************
+ * Input: std::string& indicating the file name																	 *
+ * Output: bool indicating if the file was mapped																 *
+ * Description: Maps the file, replacing any file mapped before. An empty file opens successfully with no data.  *
+ ****************************************************************************************************************/
+bool MappedFile::open(const std::string& filename)
+{
+	close();
+
+#ifdef _WIN32
+	file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		close();
+		return false;
+	}
+	size = static_cast<std::size_t>(fileSize.QuadPart);
+	if (size == 0)
+	{
+		return true;
+	}
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		close();
+		return false;
+	}
+	data = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+	int descriptor = ::open(filename.c_str(), O_RDONLY);
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(descriptor, &status) != 0)
+	{
+		::close(descriptor);
+		return false;
+	}
+	size = static_cast<std::size_t>(status.st_size);
+	if (size == 0)
+	{
+		::close(descriptor);
+		return true;
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	::close(descriptor);
+	data = (view == MAP_FAILED) ? nullptr : static_cast<const std::uint8_t*>(view);
+#endif
+
+	if (data == nullptr)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+/*****************************************************************************************************************
+ *										close()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Unmaps the file. Pointers returned by getData() are no longer valid afterwards.					 *
+ ****************************************************************************************************************/
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (data != nullptr)
+	{
+		UnmapViewOfFile(data);
+	}
+	if (mapping != nullptr)
+	{
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (data != nullptr)
+	{
+		munmap(const_cast<std::uint8_t*>(data), size);
+	}
+#endif
+	data = nullptr;
+	size = 0;
+}
+
+/*****************************************************************************************************************
+ *										Getters 																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: The mapped bytes and their count																		 *
+ * Description: Generic getter functions. getData() returns nullptr when nothing is mapped.						 *
+ ****************************************************************************************************************/
+const std::uint8_t* MappedFile::getData() const
+{
+	return data;
+}
+
+std::size_t MappedFile::getSize() const
+{
+	return size;
+}
@@ -0,0 +1,30 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class MappedFile
+{
+	public:
+								MappedFile();
+								~MappedFile();
+		bool					open(const std::string& filename);
+		void					close();
+		const std::uint8_t*		getData() const;
+		std::size_t				getSize() const;
+
+	private:
+								MappedFile(const MappedFile&);
+		MappedFile&				operator=(const MappedFile&);
+
+	private:
+		const std::uint8_t*		data;
+		std::size_t				size;
+#ifdef _WIN32
+		void*					file;
+		void*					mapping;
+#endif
+};
+#endif
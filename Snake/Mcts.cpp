@@ -0,0 +1,338 @@
+#include "Mcts.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// States of Node::firstChild before the children exist
+#define UNEXPANDED -1
+#define EXPANDING -2
+#define NO_CHILDREN -3
+// Visits a thread adds to every node on its path while its playout runs, steering other threads elsewhere
+#define VIRTUAL_LOSS 3
+#define EXPLORATION 1.4f
+// Random moves played after leaving the tree, and the discount on food eaten later in a playout
+#define ROLLOUT_TICKS 16
+#define FOOD_DISCOUNT 0.97f
+// Share of a food the playout earns for getting close to one it does not eat
+#define PROXIMITY_SHARE 0.5f
+// Deepest path through the tree a playout follows
+#define MAX_TREE_DEPTH 256
+
+namespace
+{
+	// Score for the head being near the food, from 0 across the board to PROXIMITY_SHARE next to it
+	float proximity(const GameCore& game)
+	{
+		const Cell& head = game.getBody().front();
+		const Cell& food = game.getFood();
+		int distance = std::abs(head.x - food.x) + std::abs(head.y - food.y);
+		return PROXIMITY_SHARE * (1.f - static_cast<float>(distance) / (game.getBoardWidth() + game.getBoardHeight()));
+	}
+
+	void addValue(std::atomic<float>& target, float amount)
+	{
+		float current = target.load(std::memory_order_relaxed);
+		while (!target.compare_exchange_weak(current, current + amount, std::memory_order_relaxed))
+		{
+		}
+	}
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: int number of search threads, double time budget per move in seconds, unsigned int seed for rollouts	 *
+ * Output: None																									 *
+ * Description: MctsPolicy is a tree parallel Monte Carlo tree search. All threads grow one tree whose nodes are *
+ * handed out from a preallocated arena, and a thread marks its path with a virtual loss so the others explore   *
+ * different branches. Playouts run on each thread's own GameCore, restored from a GameSnapshot of the position, *
+ * with the random number generator included, so the search plans against the food the game will really place.  *
+ * A single search thread runs on the calling thread without a pool of its own, which is how the policy runs on	 *
+ * the workers of a batch of games.																				 *
+ ****************************************************************************************************************/
+MctsPolicy::MctsPolicy(int threadCount, double budgetSeconds, unsigned int seed) : budget(budgetSeconds),
+nodes(new Node[MCTS_ARENA_NODES]), nodeCount(0), playouts(0), threadCount(std::max(1, threadCount)),
+pool(threadCount > 1 ? new ThreadPool(threadCount) : nullptr), lastPlayouts(0), lastSearchSeconds(0.0)
+{
+	for (int i = 0; i < this->threadCount; i++)
+	{
+		randoms.push_back(Random(seed, static_cast<std::uint64_t>(i)));
+	}
+}
+
+/*****************************************************************************************************************
+ *										reset()																	 *
+ *****************************************************************************************************************
+ * Input: unsigned int seed for rollouts																		 *
+ * Output: None																									 *
+ * Description: Reseeds the rollouts of every search thread as the constructor does. The arena, the thread pool	 *
+ * and the playout cores are kept, since the tree is rebuilt by every decision anyway.							 *
+ ****************************************************************************************************************/
+void MctsPolicy::reset(unsigned int seed)
+{
+	for (int i = 0; i < threadCount; i++)
+	{
+		randoms[i] = Random(seed, static_cast<std::uint64_t>(i));
+	}
+}
+
+/*****************************************************************************************************************
+ *										decide()																 *
+ *****************************************************************************************************************
+ * Input: GameCore to play																						 *
+ * Output: Direction for the next tick																			 *
+ * Description: Searches from the current position until the time budget runs out, capped at MCTS_TICK_SHARE of *
+ * the current tick so a decision always fits inside one tick, and plays the most visited move.					 *
+ ****************************************************************************************************************/
+Direction MctsPolicy::decide(const GameCore& core)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	double seconds = std::min(budget, core.getTickDuration() * MCTS_TICK_SHARE);
+	std::chrono::steady_clock::time_point deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+
+	core.snapshot(root);
+	for (int i = 0; i < threadCount; i++)
+	{
+		if (static_cast<int>(games.size()) <= i)
+		{
+			games.push_back(std::unique_ptr<GameCore>(new GameCore(core)));
+		}
+		else
+		{
+			*games[i] = core;
+		}
+	}
+
+	nodeCount = 1;
+	initializeNode(0, core.getDirection());
+	playouts = 0;
+	if (!pool)
+	{
+		search(0, deadline);
+	}
+	else
+	{
+		for (int i = 0; i < threadCount; i++)
+		{
+			pool->submit([this, i, deadline] { search(i, deadline); });
+		}
+		pool->wait();
+	}
+
+	lastPlayouts = playouts;
+	lastSearchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	int first = nodes[0].firstChild.load();
+	if (first < 0)
+	{
+		return core.getDirection();
+	}
+	int best = first;
+	for (int child = first + 1; child < first + nodes[0].childCount; child++)
+	{
+		if (nodes[child].visits.load() > nodes[best].visits.load())
+		{
+			best = child;
+		}
+	}
+	return static_cast<Direction>(nodes[best].move);
+}
+
+/*****************************************************************************************************************
+ *										search()																 *
+ *****************************************************************************************************************
+ * Input: int index of the worker, deadline of the search														 *
+ * Output: None																									 *
+ * Description: Runs playouts until the deadline. A playout walks down the tree by UCT, expands the first node	 *
+ * it reaches that has no children yet, plays random safe moves from there and adds the result to every node on	 *
+ * its path. The result is 0 for a death and at least 0.5 for surviving or winning, which step() reports with	 *
+ * GameEvent::Won once no cell is left for the food, walls and excluded cells aside. Food eaten adds up to 0.5,	 *
+ * worth less the later it is eaten. Coming close to the food earns part of that, so playouts that miss the		 *
+ * food on a large board still tell good moves from bad ones.													 *
+ ****************************************************************************************************************/
+void MctsPolicy::search(int worker, std::chrono::steady_clock::time_point deadline)
+{
+	GameCore& game = *games[worker];
+	Random& random = randoms[worker];
+	int path[MAX_TREE_DEPTH + 1];
+	long long count = 0;
+
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		game.restore(root);
+		int depth = 0;
+		int node = 0;
+		float food = 0.f;
+		float nearest = 0.f;
+		float discount = 1.f;
+		bool won = false;
+		path[0] = node;
+		nodes[node].visits.fetch_add(VIRTUAL_LOSS, std::memory_order_relaxed);
+
+		while (!game.isGameOver() && depth < MAX_TREE_DEPTH)
+		{
+			int first = nodes[node].firstChild.load(std::memory_order_acquire);
+			if (first == UNEXPANDED)
+			{
+				int expected = UNEXPANDED;
+				if (nodes[node].firstChild.compare_exchange_strong(expected, EXPANDING, std::memory_order_acquire))
+				{
+					expand(node, game);
+				}
+				break;
+			}
+			if (first < 0)
+			{
+				break;
+			}
+
+			node = selectChild(node);
+			path[++depth] = node;
+			nodes[node].visits.fetch_add(VIRTUAL_LOSS, std::memory_order_relaxed);
+			int events = game.step(static_cast<Direction>(nodes[node].move));
+			won = (events & GameEvent::Won) != 0;
+			if (events & GameEvent::AteFood)
+			{
+				food += discount;
+			}
+			else if (!game.isGameOver())
+			{
+				nearest = std::max(nearest, discount * proximity(game));
+			}
+			discount *= FOOD_DISCOUNT;
+		}
+
+		for (int tick = 0; tick < ROLLOUT_TICKS && !game.isGameOver(); tick++)
+		{
+			Direction safe[4];
+			int safeCount = 0;
+			for (Direction direction : { Down, Left, Right, Up })
+			{
+				if (isSafeMove(game, direction))
+				{
+					safe[safeCount++] = direction;
+				}
+			}
+			Direction move = (safeCount == 0) ? game.getDirection() : safe[random.nextBelow(static_cast<std::uint32_t>(safeCount))];
+			int events = game.step(move);
+			won = (events & GameEvent::Won) != 0;
+			if (events & GameEvent::AteFood)
+			{
+				food += discount;
+			}
+			discount *= FOOD_DISCOUNT;
+		}
+
+		// A game only ends on a death or on the win step() reports, so only the last step decides which
+		float reward = (game.isGameOver() && !won) ? 0.f : 0.5f + 0.5f * std::min(food + nearest, 1.f);
+		for (int i = 0; i <= depth; i++)
+		{
+			nodes[path[i]].visits.fetch_add(1 - VIRTUAL_LOSS, std::memory_order_relaxed);
+			addValue(nodes[path[i]].value, reward);
+		}
+		count++;
+	}
+	playouts += count;
+}
+
+/*****************************************************************************************************************
+ *										expand()																 *
+ *****************************************************************************************************************
+ * Input: int node claimed by this thread (marked EXPANDING), GameCore at the position of the node				 *
+ * Output: None																									 *
+ * Description: Adds one child per safe move, taken from the arena in a single atomic step, and publishes them.  *
+ * A node with no safe move, or an arena that has run out, leaves the node without children for good; playouts *
+ * then continue from it with random moves.																		 *
+ ****************************************************************************************************************/
+void MctsPolicy::expand(int node, const GameCore& game)
+{
+	Direction moves[4];
+	int count = 0;
+	for (Direction direction : { Down, Left, Right, Up })
+	{
+		if (isSafeMove(game, direction))
+		{
+			moves[count++] = direction;
+		}
+	}
+
+	int first = (count == 0) ? MCTS_ARENA_NODES : nodeCount.fetch_add(count, std::memory_order_relaxed);
+	if (first + count > MCTS_ARENA_NODES)
+	{
+		nodes[node].firstChild.store(NO_CHILDREN, std::memory_order_release);
+		return;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		initializeNode(first + i, moves[i]);
+	}
+	nodes[node].childCount = static_cast<std::uint8_t>(count);
+	nodes[node].firstChild.store(first, std::memory_order_release);
+}
+
+/*****************************************************************************************************************
+ *										selectChild()															 *
+ *****************************************************************************************************************
+ * Input: int node with children																				 *
+ * Output: int child to descend into																			 *
+ * Description: UCT: an unvisited child first, otherwise the child with the best mean result plus exploration    *
+ * bonus. Visits include the virtual losses of running playouts, which lowers the mean of busy branches.		 *
+ ****************************************************************************************************************/
+int MctsPolicy::selectChild(int node) const
+{
+	int first = nodes[node].firstChild.load(std::memory_order_acquire);
+	float logVisits = std::log(static_cast<float>(std::max(1, nodes[node].visits.load(std::memory_order_relaxed))));
+	int best = first;
+	float bestScore = -1.f;
+
+	for (int child = first; child < first + nodes[node].childCount; child++)
+	{
+		int visits = nodes[child].visits.load(std::memory_order_relaxed);
+		if (visits == 0)
+		{
+			return child;
+		}
+		float score = nodes[child].value.load(std::memory_order_relaxed) / visits + EXPLORATION * std::sqrt(logVisits / visits);
+		if (score > bestScore)
+		{
+			best = child;
+			bestScore = score;
+		}
+	}
+	return best;
+}
+
+/*****************************************************************************************************************
+ *										initializeNode()														 *
+ *****************************************************************************************************************
+ * Input: int node taken from the arena, Direction of the move leading to it									 *
+ * Output: None																									 *
+ * Description: Resets a node before it is published. Nodes are reused from move to move.						 *
+ ****************************************************************************************************************/
+void MctsPolicy::initializeNode(int node, Direction move)
+{
+	nodes[node].visits.store(0, std::memory_order_relaxed);
+	nodes[node].value.store(0.f, std::memory_order_relaxed);
+	nodes[node].firstChild.store(UNEXPANDED, std::memory_order_relaxed);
+	nodes[node].childCount = 0;
+	nodes[node].move = static_cast<std::uint8_t>(move);
+}
+
+/*****************************************************************************************************************
+ *										Getters 																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: Statistics of the last decision																		 *
+ * Description: Generic getter functions for the number of playouts and the time the last decision took.		 *
+ ****************************************************************************************************************/
+long long MctsPolicy::getLastPlayouts() const
+{
+	return lastPlayouts;
+}
+
+double MctsPolicy::getLastSearchSeconds() const
+{
+	return lastSearchSeconds;
+}
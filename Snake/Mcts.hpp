@@ -0,0 +1,59 @@
+#ifndef MCTS_HPP
+#define MCTS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "GameCore.hpp"
+#include "Policy.hpp"
+#include "Random.hpp"
+#include "ThreadPool.hpp"
+
+// Nodes in the arena shared by all search threads. 16 bytes each, so the arena takes 16 MB
+#define MCTS_ARENA_NODES (1 << 20)
+#define MCTS_DEFAULT_BUDGET 0.005
+// Share of the current tick duration a move may take at most, so the search keeps up as the snake speeds up
+#define MCTS_TICK_SHARE 0.5
+
+class MctsPolicy : public Policy
+{
+	public:
+								MctsPolicy(int threadCount, double budgetSeconds, unsigned int seed);
+		Direction				decide(const GameCore& core);
+		void					reset(unsigned int seed);
+		long long				getLastPlayouts() const;
+		double					getLastSearchSeconds() const;
+
+	private:
+		struct Node
+		{
+			std::atomic<int>	visits;
+			std::atomic<float>	value;
+			std::atomic<int>	firstChild;
+			std::uint8_t		childCount;
+			std::uint8_t		move;
+		};
+
+	private:
+		void					search(int worker, std::chrono::steady_clock::time_point deadline);
+		void					expand(int node, const GameCore& game);
+		int						selectChild(int node) const;
+		void					initializeNode(int node, Direction move);
+
+	private:
+		double					budget;
+		std::unique_ptr<Node[]>	nodes;
+		std::atomic<int>		nodeCount;
+		std::atomic<long long>	playouts;
+		GameSnapshot			root;
+		std::vector<std::unique_ptr<GameCore>>	games;
+		std::vector<Random>		randoms;
+		int						threadCount;
+		std::unique_ptr<ThreadPool>	pool;
+		long long				lastPlayouts;
+		double					lastSearchSeconds;
+};
+#endif
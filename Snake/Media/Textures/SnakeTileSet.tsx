@@ -0,0 +1,4 @@
+<?xml version="1.0" encoding="UTF-8"?>
+<tileset name="SnakeTileSet" tilewidth="32" tileheight="32" tilecount="14" columns="7">
+ <image source="Textures.png" width="224" height="64"/>
+</tileset>
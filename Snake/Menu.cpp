@@ -1,23 +1,31 @@
 #include "Menu.hpp"
 
+#include "Trace.hpp"
+
 /*****************************************************************************************************************
  *										Constructor   															 *
  *****************************************************************************************************************
- * Input: sf::RenderWindow																						 *
+ * Input: sf::RenderWindow, optional texture to draw into instead of the window									 *
  * Output: None																									 *
  * Description: The constructor initializes the window variable. It also loads all textures, soundBuffers, and   *
- * any background music. Once initialized, it sets the textures, soundBuffers, and music for the game. Finally,  *
- * it sets up the bools for the menu.																			 *
+ * any background music, decoding the files in parallel. Once initialized, it sets the textures, soundBuffers, and music for the game. Finally,  *
+ * it sets up the bools for the menu. With an offscreen texture the menu is drawn into the texture, as the Game  *
+ * does.																										 *
  ****************************************************************************************************************/
-Menu::Menu(sf::RenderWindow& window) : window(window)
+Menu::Menu(sf::RenderWindow& window, sf::RenderTexture* offscreen) : window(window), offscreen(offscreen),
+target(offscreen ? static_cast<sf::RenderTarget&>(*offscreen) : window)
 {
 	loadTextures();
 	loadSoundBuffers();
+	loadMusic();
+	menuResourceHolder.loadQueued();
 	setTextures();
 	setSoundBuffers();
 	setMusic();
 	inMenu = true;
 	hasNotHoveredButton = true;
+	focused = true;
+	dirty = true;
 	state = MenuState::ID::Neutral;
 }
 
@@ -50,6 +58,7 @@ void Menu::update()
  ****************************************************************************************************************/
 void Menu::processEvents()
 {
+	TraceSpan span("processEvents", "menu");
 	// Update background image if mouse is hovering play or exit button
 	handleMousePosition();
 
@@ -68,6 +77,22 @@ void Menu::processEvents()
 				window.close();
 				break;
 			}
+			case sf::Event::LostFocus:
+			{
+				focused = false;
+				break;
+			}
+			case sf::Event::GainedFocus:
+			{
+				focused = true;
+				dirty = true;
+				break;
+			}
+			case sf::Event::Resized:
+			{
+				dirty = true;
+				break;
+			}
 		}
 	}
 }
@@ -101,30 +126,63 @@ void Menu::handlePlayerInput(sf::Mouse::Button button, bool isPressed)
  * Description: The function renders the menu images. The images are spread into 3 different types: neutral,     *
  * play, and exit. The neutral screen displays the regular game screen. The play and exit screen display screens *
  * in which their respective buttons appear larger than normal, rendering an interactive button to the screen    *
+ * The frame pacer waits between frames, at the idle rate while the window is in the background. A frame is only *
+ * drawn when the hovered button changed or the window needs a redraw.											 *
  ****************************************************************************************************************/
 void Menu::renderMenu()
 {
+	pacer.resetStats();
 	while (window.isOpen() && inGameMenu())
 	{
-		window.clear();
+		TraceSpan frameSpan("menuFrame", "menu");
 		processEvents();
 		update();
-		// The three menu states create an interactive menu
-		if (state == MenuState::ID::Neutral)
-		{
-			window.draw(menuNeutral);
-		}
-		else if (state == MenuState::ID::Play)
+		if (dirty)
 		{
-			window.draw(menuPlay);
-		}
-		else if (state == MenuState::ID::Exit)
-		{
-			window.draw(menuExit);
+			render();
+			dirty = false;
+			pacer.markPresented();
 		}
+
+		TraceSpan waitSpan("wait", "pacing");
+		pacer.wait(!focused);
+	}
+	target.clear();
+}
+
+/*****************************************************************************************************************
+ *										render()  																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Draws one frame of the menu, showing the image of the current state.							 *
+ ****************************************************************************************************************/
+void Menu::render()
+{
+	TraceSpan span("render", "menu");
+	target.clear();
+	// The three menu states create an interactive menu
+	if (state == MenuState::ID::Neutral)
+	{
+		target.draw(menuNeutral);
+	}
+	else if (state == MenuState::ID::Play)
+	{
+		target.draw(menuPlay);
+	}
+	else if (state == MenuState::ID::Exit)
+	{
+		target.draw(menuExit);
+	}
+
+	if (offscreen)
+	{
+		offscreen->display();
+	}
+	else
+	{
 		window.display();
 	}
-	window.clear();
 }
 
 /*****************************************************************************************************************
@@ -137,9 +195,30 @@ void Menu::renderMenu()
  ****************************************************************************************************************/
 void Menu::run()
 {
-	menuMusic.play();
+	menuMusic->play();
 	renderMenu();
-	menuMusic.stop();
+	menuMusic->stop();
+}
+
+/*****************************************************************************************************************
+ *										setFramePacing()														 *
+ *****************************************************************************************************************
+ * Input: FramePacing for the menu loop																			 *
+ * Output: None																									 *
+ * Description: Sets the frame rate limits of renderMenu() and switches the window's vsync to match.			 *
+ ****************************************************************************************************************/
+void Menu::setFramePacing(const FramePacing& pacing)
+{
+	pacer.setPacing(pacing);
+	if (!offscreen)
+	{
+		pacer.apply(window);
+	}
+}
+
+PacingStats Menu::getPacingStats() const
+{
+	return pacer.getStats();
 }
 
 /*****************************************************************************************************************
@@ -147,12 +226,25 @@ void Menu::run()
  *****************************************************************************************************************
  * Input: None																									 *
  * Output: None																									 *
- * Description: The function loads the game's sound buffers into the menu's resourceHolder instance for later    *
+ * Description: The function queues the game's sound buffers on the menu's resourceHolder instance for later     *
  * use.																											 *
  ****************************************************************************************************************/
 void Menu::loadSoundBuffers()
 {
-	menuResourceHolder.loadSoundBuffers(SoundBuffers::ID::Hover, "Media/SoundBuffers/Hover.wav");
+	menuResourceHolder.queueSoundBuffers(SoundBuffers::ID::Hover, "Media/SoundBuffers/Hover.wav");
+}
+
+/*****************************************************************************************************************
+ *										loadMusic()  															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: The function queues the menu's background music on the menu's resourceHolder instance for later  *
+ * use.																											 *
+ ****************************************************************************************************************/
+void Menu::loadMusic()
+{
+	menuResourceHolder.queueMusic(Music::ID::Menu, "Media/SoundBuffers/MenuBackgroundSong.ogg");
 }
 
 /*****************************************************************************************************************
@@ -160,14 +252,14 @@ void Menu::loadSoundBuffers()
  *****************************************************************************************************************
  * Input: None																									 *
  * Output: None																									 *
- * Description: The function loads the game's textures into the menu's resourceHolder instance for later         *
+ * Description: The function queues the game's textures on the menu's resourceHolder instance for later          *
  * use.																											 *
  ****************************************************************************************************************/
 void Menu::loadTextures()
 {
-	menuResourceHolder.loadTextures(Textures::ID::MenuNeutral, "Media/Textures/Menu/LoadScreenNeutral.png");
-	menuResourceHolder.loadTextures(Textures::ID::MenuPlay, "Media/Textures/Menu/LoadScreenPlay.png");
-	menuResourceHolder.loadTextures(Textures::ID::MenuExit, "Media/Textures/Menu/LoadScreenExit.png");
+	menuResourceHolder.queueTextures(Textures::ID::MenuNeutral, "Media/Textures/Menu/LoadScreenNeutral.png");
+	menuResourceHolder.queueTextures(Textures::ID::MenuPlay, "Media/Textures/Menu/LoadScreenPlay.png");
+	menuResourceHolder.queueTextures(Textures::ID::MenuExit, "Media/Textures/Menu/LoadScreenExit.png");
 }
 
 /*****************************************************************************************************************
@@ -207,8 +299,8 @@ void Menu::setSoundBuffers()
  ****************************************************************************************************************/
 void Menu::setMusic()
 {
-	menuMusic.openFromFile("Media/SoundBuffers/MenuBackgroundSong.ogg");
-	menuMusic.setVolume(MUSIC_VOLUME);
+	menuMusic = &menuResourceHolder.getMusic(Music::ID::Menu);
+	menuMusic->setVolume(MUSIC_VOLUME);
 }
 
 /*****************************************************************************************************************
@@ -218,11 +310,12 @@ void Menu::setMusic()
  * Output: None																									 *
  * Description: The function tracks the mouses position and responds accordingly if the mouse is on the play     *
  * or exit buttons. If on the play button or exit button, the image shifts to make the buttons look interactive  *
- * and also play sound effects.																					 *
+ * and also play sound effects. A change of state marks the menu for a redraw.									 *
  ****************************************************************************************************************/
 void Menu::handleMousePosition()
 {
 	sf::Vector2i position = mouse.getPosition();
+	MenuState::ID shownState = state;
 
 	if (insidePlayButton())
 	{
@@ -249,6 +342,12 @@ void Menu::handleMousePosition()
 		state = MenuState::ID::Neutral;
 		hasNotHoveredButton = true;
 	}
+
+	// Only a change of the hovered button changes the picture
+	if (state != shownState)
+	{
+		dirty = true;
+	}
 }
 
 /*****************************************************************************************************************
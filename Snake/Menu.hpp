@@ -1,6 +1,7 @@
 #ifndef MENU_HPP
 #define MENU_HPP
 
+#include "FramePacer.hpp"
 #include "GameState.hpp"
 #include "ResourceHolder.hpp"
 
@@ -14,37 +15,49 @@ namespace MenuState
 class Menu : public GameState
 {
 	public:
-								Menu(sf::RenderWindow& window);
+								Menu(sf::RenderWindow& window, sf::RenderTexture* offscreen = nullptr);
 		bool					inGameMenu();
 		void					renderMenu();
 		void					run();
+		void					setFramePacing(const FramePacing& pacing);
+		PacingStats				getPacingStats() const;
 
 	private:
 		void					processEvents();
 		void					update();
+		void					render();
 		void					handlePlayerInput(sf::Mouse::Button button, bool isPressed);
 		void					handleMousePosition();
 		void					loadTextures();
 		void					loadSoundBuffers();
+		void					loadMusic();
 		void					setTextures();
 		void					setSoundBuffers();
 		void					setMusic();
 		bool					insidePlayButton();
 		bool					insideExitButton();
 
+		// Drives the menu frame by frame to time it
+		friend class			ScenarioRunner;
+
 	private:
 		bool					inMenu;
 		bool					hasNotHoveredButton;
+		bool					focused;
+		bool					dirty;
 		sf::Texture				neutral;
 		sf::Sprite				menuNeutral;
 		sf::Sprite				menuPlay;
 		sf::Sprite				menuExit;
 		sf::RenderWindow&		window;
+		sf::RenderTexture*		offscreen;
+		sf::RenderTarget&		target;
 		MenuState::ID			state;
 		ResourceHolder			menuResourceHolder;
 		sf::Mouse				mouse;
 		sf::Sound				hoverSound;
-		sf::Music				menuMusic;
+		sf::Music*				menuMusic;
+		FramePacer				pacer;
 
 
 };
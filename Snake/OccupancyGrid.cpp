@@ -0,0 +1,219 @@
+#include "OccupancyGrid.hpp"
+
+#include <cassert>
+#include <cstring>
+
+/*****************************************************************************************************************
+ *										countBits() / selectBit()												 *
+ *****************************************************************************************************************
+ * Input: std::uint64_t word / and int n, smaller than the number of set bits of the word						 *
+ * Output: int number of set bits / int position of the n-th set bit, counting from 0 at the lowest bit			 *
+ * Description: Portable bit counting: the bits are summed in pairs, nibbles and bytes, and a multiplication	 *
+ * adds the bytes up. selectBit() skips whole bytes by their counts before it looks at single bits, so it takes	 *
+ * at most 16 steps.																							 *
+ ****************************************************************************************************************/
+int countBits(std::uint64_t word)
+{
+	word = word - ((word >> 1) & 0x5555555555555555ull);
+	word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+	return static_cast<int>((word * 0x0101010101010101ull) >> 56);
+}
+
+int selectBit(std::uint64_t word, int n)
+{
+	assert(n >= 0 && n < countBits(word));
+	int position = 0;
+	for (int bits = countBits(word & 0xFF); bits <= n; bits = countBits(word & 0xFF))
+	{
+		n -= bits;
+		word >>= 8;
+		position += 8;
+	}
+	while (true)
+	{
+		if ((word & 1) != 0 && n-- == 0)
+		{
+			return position;
+		}
+		word >>= 1;
+		position++;
+	}
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: The constructor creates an empty grid with no cells. resize() must be called before the grid can *
+ * be used to track anything.																					 *
+ ****************************************************************************************************************/
+OccupancyGrid::OccupancyGrid() : width(0), height(0)
+{
+	clear();
+}
+
+/*****************************************************************************************************************
+ *										resize()   																 *
+ *****************************************************************************************************************
+ * Input: int width and int height of the board in cells														 *
+ * Output: None																									 *
+ * Description: Sets the dimensions of the board and clears every cell. The storage is a fixed size bitset, so   *
+ * resizing never allocates; the board must simply fit within MAX_BOARD_CELLS.									 *
+ ****************************************************************************************************************/
+void OccupancyGrid::resize(int width, int height)
+{
+	assert(width >= 0 && height >= 0 && width * height <= MAX_BOARD_CELLS);
+	this->width = width;
+	this->height = height;
+	clear();
+}
+
+/*****************************************************************************************************************
+ *										clear()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Marks every cell on the board as free.															 *
+ ****************************************************************************************************************/
+void OccupancyGrid::clear()
+{
+	std::memset(cells, 0, sizeof(cells));
+}
+
+/*****************************************************************************************************************
+ *										set()   																 *
+ *****************************************************************************************************************
+ * Input: int x and int y of the cell																			 *
+ * Output: None																									 *
+ * Description: Marks a cell as occupied. The cell must lie on the board.										 *
+ ****************************************************************************************************************/
+void OccupancyGrid::set(int x, int y)
+{
+	int index = y * width + x;
+	cells[index / GRID_WORD_BITS] |= (std::uint64_t(1) << (index % GRID_WORD_BITS));
+}
+
+/*****************************************************************************************************************
+ *										reset()   																 *
+ *****************************************************************************************************************
+ * Input: int x and int y of the cell																			 *
+ * Output: None																									 *
+ * Description: Marks a cell as free. The cell must lie on the board.											 *
+ ****************************************************************************************************************/
+void OccupancyGrid::reset(int x, int y)
+{
+	int index = y * width + x;
+	cells[index / GRID_WORD_BITS] &= ~(std::uint64_t(1) << (index % GRID_WORD_BITS));
+}
+
+/*****************************************************************************************************************
+ *										test()   																 *
+ *****************************************************************************************************************
+ * Input: int x and int y of the cell																			 *
+ * Output: bool indicating if the cell is occupied																 *
+ * Description: Single lookup that replaces scanning the snake's body. The cell must lie on the board; use        *
+ * contains() first when the coordinates may be off the board.													 *
+ ****************************************************************************************************************/
+bool OccupancyGrid::test(int x, int y) const
+{
+	int index = y * width + x;
+	return ((cells[index / GRID_WORD_BITS] >> (index % GRID_WORD_BITS)) & 1) != 0;
+}
+
+/*****************************************************************************************************************
+ *										contains()   															 *
+ *****************************************************************************************************************
+ * Input: int x and int y of the cell																			 *
+ * Output: bool indicating if the cell lies on the board														 *
+ * Description: Bounds check used for wall collisions. Anything outside of the board counts as a wall.           *
+ ****************************************************************************************************************/
+bool OccupancyGrid::contains(int x, int y) const
+{
+	return (x >= 0 && x < width && y >= 0 && y < height);
+}
+
+/*****************************************************************************************************************
+ *										merge()																	 *
+ *****************************************************************************************************************
+ * Input: OccupancyGrid of the same board																		 *
+ * Output: None																									 *
+ * Description: Marks every cell the other grid marks as occupied too, a word at a time, such as the walls of	 *
+ * the board on top of the snake.																				 *
+ ****************************************************************************************************************/
+void OccupancyGrid::merge(const OccupancyGrid& other)
+{
+	assert(other.width == width && other.height == height);
+	for (int i = 0; i < MAX_BOARD_CELLS / GRID_WORD_BITS; i++)
+	{
+		cells[i] |= other.cells[i];
+	}
+}
+
+/*****************************************************************************************************************
+ *										countFree() / findFree()												 *
+ *****************************************************************************************************************
+ * Input: OccupancyGrid of the same board holding cells to skip / and int n, smaller than countFree()			 *
+ * Output: int number of cells on the board that neither grid marks / int index (y * width + x) of the n-th of	 *
+ * them																											 *
+ * Description: Drawing n uniformly below countFree() and taking findFree(n) picks a uniformly random free		 *
+ * cell, such as the cell for the food. Both work a word of 64 cells at a time, so the cost is bounded by the	 *
+ * size of the board however full it is, and the cell picked depends on nothing but the two grids and n.		 *
+ ****************************************************************************************************************/
+int OccupancyGrid::countFree(const OccupancyGrid& excluded) const
+{
+	assert(excluded.width == width && excluded.height == height);
+	int count = 0;
+	for (int word = 0; word * GRID_WORD_BITS < width * height; word++)
+	{
+		count += countBits(freeWord(word, excluded));
+	}
+	return count;
+}
+
+int OccupancyGrid::findFree(int n, const OccupancyGrid& excluded) const
+{
+	assert(excluded.width == width && excluded.height == height);
+	for (int word = 0; word * GRID_WORD_BITS < width * height; word++)
+	{
+		std::uint64_t free = freeWord(word, excluded);
+		int count = countBits(free);
+		if (n < count)
+		{
+			return word * GRID_WORD_BITS + selectBit(free, n);
+		}
+		n -= count;
+	}
+	assert(false);
+	return -1;
+}
+
+// The cells of one word that neither grid marks, leaving out the bits past the end of the board
+std::uint64_t OccupancyGrid::freeWord(int word, const OccupancyGrid& excluded) const
+{
+	std::uint64_t free = ~(cells[word] | excluded.cells[word]);
+	int remaining = width * height - word * GRID_WORD_BITS;
+	if (remaining < GRID_WORD_BITS)
+	{
+		free &= (std::uint64_t(1) << remaining) - 1;
+	}
+	return free;
+}
+
+/*****************************************************************************************************************
+ *										getWidth() / getHeight()												 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: int dimension of the board in cells																	 *
+ * Description: Generic getter functions for the board dimensions.												 *
+ ****************************************************************************************************************/
+int OccupancyGrid::getWidth() const
+{
+	return width;
+}
+
+int OccupancyGrid::getHeight() const
+{
+	return height;
+}
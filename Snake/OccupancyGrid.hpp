@@ -0,0 +1,38 @@
+#ifndef OCCUPANCYGRID_HPP
+#define OCCUPANCYGRID_HPP
+
+#include <cstdint>
+
+// Largest board (in cells) any grid can describe. 1024 covers the 32 x 28 game board with room to spare
+#define MAX_BOARD_CELLS 1024
+#define GRID_WORD_BITS 64
+
+// Number of set bits in a word / position of the n-th set bit of a word, counting from 0 at the lowest bit
+int								countBits(std::uint64_t word);
+int								selectBit(std::uint64_t word, int n);
+
+class OccupancyGrid
+{
+	public:
+								OccupancyGrid();
+		void					resize(int width, int height);
+		void					clear();
+		void					set(int x, int y);
+		void					reset(int x, int y);
+		bool					test(int x, int y) const;
+		bool					contains(int x, int y) const;
+		void					merge(const OccupancyGrid& other);
+		int						countFree(const OccupancyGrid& excluded) const;
+		int						findFree(int n, const OccupancyGrid& excluded) const;
+		int						getWidth() const;
+		int						getHeight() const;
+
+	private:
+		std::uint64_t			freeWord(int word, const OccupancyGrid& excluded) const;
+
+	private:
+		int						width;
+		int						height;
+		std::uint64_t			cells[MAX_BOARD_CELLS / GRID_WORD_BITS];
+};
+#endif
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "AssetPack.hpp"
+#include "AtlasLayout.hpp"
+#include "ResourceHolder.hpp"
+
+// Loads of the whole asset set timed per source by --compare, the first of which is the cold one
+#define DEFAULT_RUNS 5
+
+/*****************************************************************************************************************
+ *										SnakePack																 *
+ *****************************************************************************************************************
+ * Packs every file the game and the menu load into one asset pack, which the game maps at start up instead of	 *
+ * opening the loose files under Media/. Runs from the directory that holds Media/, as the game does; the		 *
+ * post build step of the project runs it there after every build.												 *
+ *																												 *
+ * Usage: SnakePack [--raw-textures] [--output Media.pack]														 *
+ *        SnakePack --compare [--runs N] [--output Media.pack]													 *
+ *																												 *
+ * With --raw-textures the PNG files are decoded now and stored as RGBA pixels, so the game uploads them		 *
+ * straight from the mapped pack without decoding anything. The pack is larger on disk for it.					 *
+ *																												 *
+ * --compare loads the whole asset set N times from the loose files and N times from the pack and reports the	 *
+ * first load of each, which is the cold one if the file cache was dropped beforehand (on Linux				 *
+ * sync; echo 3 > /proc/sys/vm/drop_caches, on Windows a reboot or RAMMap's Empty Standby List), and the mean of *
+ * the other, warm, loads.																						 *
+ ****************************************************************************************************************/
+
+namespace
+{
+	struct Asset
+	{
+		Assets::Kind		kind;
+		int					id;
+		const char*			filename;
+	};
+
+	// Everything Game and Menu load, under the IDs they load it with. Keep in step with their load functions and with
+	// the tile sets BOARD_MAP uses, which TileMap reads from the pack by the names it resolves them to
+	const Asset assets[] =
+	{
+		{ Assets::Texture, Textures::ID::Atlas, ATLAS_FILE },
+		{ Assets::Texture, Textures::ID::MenuNeutral, "Media/Textures/Menu/LoadScreenNeutral.png" },
+		{ Assets::Texture, Textures::ID::MenuPlay, "Media/Textures/Menu/LoadScreenPlay.png" },
+		{ Assets::Texture, Textures::ID::MenuExit, "Media/Textures/Menu/LoadScreenExit.png" },
+		{ Assets::SoundBuffer, SoundBuffers::ID::Munch, "Media/SoundBuffers/Munch.wav" },
+		{ Assets::SoundBuffer, SoundBuffers::ID::Death, "Media/SoundBuffers/Lose.wav" },
+		{ Assets::SoundBuffer, SoundBuffers::ID::Hover, "Media/SoundBuffers/Hover.wav" },
+		{ Assets::Music, Music::ID::Menu, "Media/SoundBuffers/MenuBackgroundSong.ogg" },
+		{ Assets::Font, Fonts::ID::Bauhaus, "Media/Fonts/Bauhaus93.ttf" },
+		{ Assets::Map, 0, "Media/Textures/SnakeBoard.tmx" },
+		{ Assets::Map, 0, "Media/Textures/SnakeTileSet.tsx" },
+		{ Assets::Map, 0, "Media/Textures/SnakeBoardTiles.tsx" }
+	};
+	const int assetCount = static_cast<int>(sizeof(assets) / sizeof(assets[0]));
+
+	struct PackedAsset
+	{
+		PackEntry					entry;
+		std::vector<std::uint8_t>	bytes;
+	};
+
+	bool readFile(const std::string& filename, std::vector<std::uint8_t>& bytes)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	std::uint64_t alignUp(std::uint64_t offset)
+	{
+		return (offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+	}
+
+	// Reads every asset, lays the pack out (header, table of contents sorted by name, aligned assets) and writes it
+	bool buildPack(const std::string& output, bool rawTextures)
+	{
+		std::vector<PackedAsset> packed(assetCount);
+		for (int i = 0; i < assetCount; i++)
+		{
+			PackedAsset& asset = packed[i];
+			std::memset(&asset.entry, 0, sizeof(asset.entry));
+			if (std::strlen(assets[i].filename) >= PACK_NAME_SIZE)
+			{
+				std::cerr << assets[i].filename << " is too long a name for the pack" << std::endl;
+				return false;
+			}
+			std::strcpy(asset.entry.name, assets[i].filename);
+
+			if (rawTextures && assets[i].kind == Assets::Texture)
+			{
+				sf::Image image;
+				if (!image.loadFromFile(assets[i].filename))
+				{
+					std::cerr << "Could not read " << assets[i].filename << std::endl;
+					return false;
+				}
+				const std::uint8_t* pixels = image.getPixelsPtr();
+				asset.bytes.assign(pixels, pixels + image.getSize().x * image.getSize().y * 4);
+				asset.entry.format = PackFormat::Rgba;
+				asset.entry.width = image.getSize().x;
+				asset.entry.height = image.getSize().y;
+			}
+			else if (!readFile(assets[i].filename, asset.bytes))
+			{
+				std::cerr << "Could not read " << assets[i].filename << std::endl;
+				return false;
+			}
+			else
+			{
+				asset.entry.format = PackFormat::File;
+			}
+			asset.entry.size = asset.bytes.size();
+		}
+		std::sort(packed.begin(), packed.end(), [](const PackedAsset& a, const PackedAsset& b) { return std::strcmp(a.entry.name, b.entry.name) < 0; });
+
+		std::uint64_t offset = sizeof(PackHeader) + sizeof(PackEntry) * packed.size();
+		for (PackedAsset& asset : packed)
+		{
+			offset = alignUp(offset);
+			asset.entry.offset = offset;
+			offset += asset.entry.size;
+		}
+		PackHeader header = { PACK_MAGIC, PACK_VERSION, static_cast<std::uint16_t>(packed.size()), offset };
+
+		std::ofstream file(output, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		for (const PackedAsset& asset : packed)
+		{
+			file.write(reinterpret_cast<const char*>(&asset.entry), sizeof(asset.entry));
+		}
+		std::uint64_t position = sizeof(PackHeader) + sizeof(PackEntry) * packed.size();
+		const char padding[PACK_ALIGNMENT] = {};
+		for (const PackedAsset& asset : packed)
+		{
+			file.write(padding, static_cast<std::streamsize>(asset.entry.offset - position));
+			file.write(reinterpret_cast<const char*>(asset.bytes.data()), static_cast<std::streamsize>(asset.bytes.size()));
+			position = asset.entry.offset + asset.entry.size;
+		}
+		if (!file)
+		{
+			std::cerr << "Could not write " << output << std::endl;
+			return false;
+		}
+		std::cout << output << ": " << packed.size() << " assets, " << offset << " bytes" << (rawTextures ? ", raw textures" : "") << "\n";
+		return true;
+	}
+
+	// Loads the whole asset set once, as the game and the menu do, and returns the time it took in milliseconds
+	double loadAll(const AssetPack* pack)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ResourceHolder::setAssetPack(pack);
+		ResourceHolder resourceHolder;
+		for (const Asset& asset : assets)
+		{
+			switch (asset.kind)
+			{
+				case Assets::Texture: resourceHolder.queueTextures(static_cast<Textures::ID>(asset.id), asset.filename); break;
+				case Assets::SoundBuffer: resourceHolder.queueSoundBuffers(static_cast<SoundBuffers::ID>(asset.id), asset.filename); break;
+				case Assets::Music: resourceHolder.queueMusic(static_cast<Music::ID>(asset.id), asset.filename); break;
+				case Assets::Font: resourceHolder.queueFonts(static_cast<Fonts::ID>(asset.id), asset.filename); break;
+				case Assets::Map: break;
+			}
+		}
+		if (!resourceHolder.loadQueued())
+		{
+			std::cerr << "Some assets did not load" << std::endl;
+		}
+		ResourceHolder::setAssetPack(nullptr);
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void printTimes(const std::string& source, const std::vector<double>& times)
+	{
+		double warm = 0.0;
+		for (std::size_t i = 1; i < times.size(); i++)
+		{
+			warm += times[i];
+		}
+		std::cout << source << ": cold " << times[0] << " ms";
+		if (times.size() > 1)
+		{
+			std::cout << ", warm " << warm / (times.size() - 1) << " ms";
+		}
+		std::cout << "\n";
+	}
+
+	// Times the loose files against the pack. The pack is opened inside the timed region, as the game opens it
+	bool compare(const std::string& packFile, int runs)
+	{
+		ResourceHolder::setLogging(false);
+		std::vector<double> loose;
+		std::vector<double> packed;
+		for (int run = 0; run < runs; run++)
+		{
+			loose.push_back(loadAll(nullptr));
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			AssetPack pack;
+			if (!pack.open(packFile))
+			{
+				std::cerr << packFile << " is not an asset pack, build it with SnakePack first" << std::endl;
+				return false;
+			}
+			double openMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			packed.push_back(openMs + loadAll(&pack));
+		}
+		printTimes("loose files", loose);
+		printTimes(packFile, packed);
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string output = PACK_FILE;
+	bool rawTextures = false;
+	bool comparing = false;
+	int runs = DEFAULT_RUNS;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--raw-textures")
+		{
+			rawTextures = true;
+		}
+		else if (option == "--compare")
+		{
+			comparing = true;
+		}
+		else if (option == "--output" && i + 1 < argc)
+		{
+			output = argv[++i];
+		}
+		else if (option == "--runs" && i + 1 < argc)
+		{
+			runs = std::max(1, std::atoi(argv[++i]));
+		}
+		else
+		{
+			std::cerr << "Usage: SnakePack [--raw-textures] [--output file] | --compare [--runs N] [--output file]" << std::endl;
+			return 1;
+		}
+	}
+
+	if (comparing)
+	{
+		return compare(output, runs) ? 0 : 1;
+	}
+	return buildPack(output, rawTextures) ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+#include "Policy.hpp"
+#include "Autopilot.hpp"
+#include "Hamilton.hpp"
+#include "Mcts.hpp"
+
+#include <cstdlib>
+#include <thread>
+
+namespace
+{
+	const Direction allDirections[] = { Down, Left, Right, Up };
+
+	void offset(Direction direction, int& x, int& y)
+	{
+		switch (direction)
+		{
+			case Down:	y += 1; break;
+			case Left:	x -= 1; break;
+			case Right:	x += 1; break;
+			case Up:	y -= 1; break;
+		}
+	}
+
+	bool isReverse(Direction facing, Direction direction)
+	{
+		return (facing == Up && direction == Down) || (facing == Down && direction == Up) ||
+			(facing == Left && direction == Right) || (facing == Right && direction == Left);
+	}
+}
+
+Policy::~Policy()
+{
+}
+
+/*****************************************************************************************************************
+ *										reset()																	 *
+ *****************************************************************************************************************
+ * Input: unsigned int seed, as passed to createPolicy()														 *
+ * Output: None																									 *
+ * Description: Prepares the policy for a new game, which then plays exactly as with a policy just created with	 *
+ * the seed. What the policy allocated is kept, so tools that play many games build each policy once. Policies	 *
+ * without state between games keep this default, which does nothing.											 *
+ ****************************************************************************************************************/
+void Policy::reset(unsigned int)
+{
+}
+
+/*****************************************************************************************************************
+ *										isSafeMove()															 *
+ *****************************************************************************************************************
+ * Input: GameCore to inspect, Direction to test																 *
+ * Output: bool indicating if moving in the direction survives the next tick									 *
+ * Description: A move is safe when the head stays on the board and lands on a cell that is neither a wall nor	 *
+ * part of the body. The tail cell counts as free because the tail moves away on the same tick, unless the head	 *
+ * is about to eat and the snake grows. Turning back onto the body is never safe.								 *
+ ****************************************************************************************************************/
+bool isSafeMove(const GameCore& core, Direction direction)
+{
+	if (isReverse(core.getDirection(), direction))
+	{
+		return false;
+	}
+
+	int x = core.getBody().front().x;
+	int y = core.getBody().front().y;
+	offset(direction, x, y);
+
+	Cell tail = core.getBody().back();
+	bool eats = (x == core.getFood().x && y == core.getFood().y);
+	if (!eats && x == tail.x && y == tail.y)
+	{
+		return true;
+	}
+	return !core.isBlocked(x, y);
+}
+
+/*****************************************************************************************************************
+ *										RandomPolicy															 *
+ *****************************************************************************************************************
+ * Input: unsigned int seed																						 *
+ * Output: Direction																							 *
+ * Description: Picks uniformly between the safe moves, or keeps going straight when there are none. Each policy *
+ * owns its random number generator, so policies on different threads never share state.                        *
+ ****************************************************************************************************************/
+RandomPolicy::RandomPolicy(unsigned int seed) : random(seed)
+{
+}
+
+void RandomPolicy::reset(unsigned int seed)
+{
+	random = Random(seed);
+}
+
+Direction RandomPolicy::decide(const GameCore& core)
+{
+	Direction safe[4];
+	int count = 0;
+	for (Direction direction : allDirections)
+	{
+		if (isSafeMove(core, direction))
+		{
+			safe[count++] = direction;
+		}
+	}
+
+	if (count == 0)
+	{
+		return core.getDirection();
+	}
+	return safe[random.nextBelow(static_cast<std::uint32_t>(count))];
+}
+
+/*****************************************************************************************************************
+ *										GreedyPolicy															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: Direction																							 *
+ * Description: Picks the safe move that brings the head closest to the food by Manhattan distance. It never     *
+ * plans ahead, so it regularly traps itself once the snake gets long.											 *
+ ****************************************************************************************************************/
+Direction GreedyPolicy::decide(const GameCore& core)
+{
+	Direction best = core.getDirection();
+	int bestDistance = -1;
+
+	for (Direction direction : allDirections)
+	{
+		if (!isSafeMove(core, direction))
+		{
+			continue;
+		}
+
+		int x = core.getBody().front().x;
+		int y = core.getBody().front().y;
+		offset(direction, x, y);
+		int distance = std::abs(x - core.getFood().x) + std::abs(y - core.getFood().y);
+		if (bestDistance < 0 || distance < bestDistance)
+		{
+			best = direction;
+			bestDistance = distance;
+		}
+	}
+	return best;
+}
+
+/*****************************************************************************************************************
+ *										isPolicyName()															 *
+ *****************************************************************************************************************
+ * Input: std::string name of a policy																			 *
+ * Output: bool indicating if createPolicy() knows the name														 *
+ * Description: Checks a command line argument without building the policy, which for mcts would start its		 *
+ * search threads and allocate its node arena.																	 *
+ ****************************************************************************************************************/
+bool isPolicyName(const std::string& name)
+{
+	return name == "random" || name == "greedy" || name == "autopilot" || name == "hamilton" || name == "mcts";
+}
+
+/*****************************************************************************************************************
+ *										createPolicy()															 *
+ *****************************************************************************************************************
+ * Input: std::string name of the policy ("random", "greedy", "autopilot", "hamilton" or "mcts"),	 *
+ *        unsigned int seed, int number of search threads for mcts, 0 for one per core							 *
+ * Output: std::unique_ptr<Policy>, empty when the name is unknown												 *
+ * Description: Factory used by the headless tools to build a policy from a command line argument. Callers that	 *
+ * already run on one thread per core, such as the workers of SnakeSim's batch, pass 1 search thread so mcts	 *
+ * does not start a pool of its own on every worker.															 *
+ ****************************************************************************************************************/
+std::unique_ptr<Policy> createPolicy(const std::string& name, unsigned int seed, int searchThreads)
+{
+	if (name == "random")
+	{
+		return std::unique_ptr<Policy>(new RandomPolicy(seed));
+	}
+	if (name == "greedy")
+	{
+		return std::unique_ptr<Policy>(new GreedyPolicy());
+	}
+	if (name == "autopilot")
+	{
+		return std::unique_ptr<Policy>(new AutopilotPolicy());
+	}
+	if (name == "hamilton")
+	{
+		return std::unique_ptr<Policy>(new HamiltonPolicy());
+	}
+	if (name == "mcts")
+	{
+		return std::unique_ptr<Policy>(new MctsPolicy(searchThreads > 0 ? searchThreads : static_cast<int>(std::thread::hardware_concurrency()),
+			MCTS_DEFAULT_BUDGET, seed));
+	}
+	return std::unique_ptr<Policy>();
+}
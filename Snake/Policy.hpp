@@ -0,0 +1,39 @@
+#ifndef POLICY_HPP
+#define POLICY_HPP
+
+#include <memory>
+#include <string>
+
+#include "GameCore.hpp"
+#include "Random.hpp"
+
+// A Policy chooses the direction for the next tick of a GameCore in place of a human player
+class Policy
+{
+	public:
+		virtual					~Policy();
+		virtual Direction		decide(const GameCore& core) = 0;
+		virtual void			reset(unsigned int seed);
+};
+
+class RandomPolicy : public Policy
+{
+	public:
+		explicit				RandomPolicy(unsigned int seed);
+		Direction				decide(const GameCore& core);
+		void					reset(unsigned int seed);
+
+	private:
+		Random					random;
+};
+
+class GreedyPolicy : public Policy
+{
+	public:
+		Direction				decide(const GameCore& core);
+};
+
+bool							isSafeMove(const GameCore& core, Direction direction);
+bool							isPolicyName(const std::string& name);
+std::unique_ptr<Policy>			createPolicy(const std::string& name, unsigned int seed, int searchThreads = 0);
+#endif
@@ -0,0 +1,126 @@
+#include "ProfilerOverlay.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+	// Frame times of 60 and 30 frames per second, drawn as guide lines across the graph
+	const float guideLines[] = { 1000.0f / 60.0f, 1000.0f / 30.0f };
+
+	void setQuad(sf::Vertex* quad, float left, float top, float width, float height, sf::Color color)
+	{
+		quad[0] = sf::Vertex(sf::Vector2f(left, top), color);
+		quad[1] = sf::Vertex(sf::Vector2f(left + width, top), color);
+		quad[2] = sf::Vertex(sf::Vector2f(left + width, top + height), color);
+		quad[3] = sf::Vertex(sf::Vector2f(left, top + height), color);
+	}
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: sf::RenderTarget the overlay is drawn on, sf::Font of the text										 *
+ * Output: None																									 *
+ * Description: Places the panel in the top right corner of the target. The overlay starts hidden.				 *
+ ****************************************************************************************************************/
+ProfilerOverlay::ProfilerOverlay(sf::RenderTarget& target, const sf::Font& font) : target(target), visible(false),
+textFrame(-1), graph(sf::Quads, (PROFILE_HISTORY + 2) * 4)
+{
+	float left = static_cast<float>(target.getSize().x) - OVERLAY_WIDTH;
+	panel.setPosition(left, 0);
+	panel.setSize(sf::Vector2f(OVERLAY_WIDTH, OVERLAY_HEIGHT));
+	panel.setFillColor(sf::Color(0, 0, 0, 180));
+
+	text.setFont(font);
+	text.setCharacterSize(16);
+	text.setPosition(left + 8, OVERLAY_GRAPH_HEIGHT + 8);
+}
+
+/*****************************************************************************************************************
+ *										toggle()																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Shows or hides the overlay. Profiling runs while the overlay is shown, so a game that never opens *
+ * it pays nothing but a flag test per timed region. Frames recorded earlier are kept for the exit dump.		 *
+ ****************************************************************************************************************/
+void ProfilerOverlay::toggle()
+{
+	visible = !visible;
+	if (visible)
+	{
+		FrameProfiler::setEnabled(true);
+		textFrame = -1;
+	}
+}
+
+bool ProfilerOverlay::isVisible() const
+{
+	return visible;
+}
+
+/*****************************************************************************************************************
+ *										render()																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Draws the last PROFILE_HISTORY frame times as bars, newest on the right, coloured by the guide	 *
+ * line they cross, and the percentile table under them.														 *
+ ****************************************************************************************************************/
+void ProfilerOverlay::render()
+{
+	if (!visible)
+	{
+		return;
+	}
+	ScopedTimer timer(Phase::ID::Overlay);
+
+	float left = panel.getPosition().x;
+	float barWidth = static_cast<float>(OVERLAY_WIDTH) / PROFILE_HISTORY;
+	for (int age = 0; age < PROFILE_HISTORY; age++)
+	{
+		float milliseconds = FrameProfiler::instance().getFrameHistory(age);
+		float height = std::min(milliseconds, OVERLAY_GRAPH_MS) / OVERLAY_GRAPH_MS * OVERLAY_GRAPH_HEIGHT;
+		sf::Color color = milliseconds <= guideLines[0] ? sf::Color::Green : (milliseconds <= guideLines[1] ? sf::Color::Yellow : sf::Color::Red);
+		setQuad(&graph[age * 4], left + (PROFILE_HISTORY - 1 - age) * barWidth, OVERLAY_GRAPH_HEIGHT - height, barWidth, height, color);
+	}
+	for (int i = 0; i < 2; i++)
+	{
+		float top = OVERLAY_GRAPH_HEIGHT - guideLines[i] / OVERLAY_GRAPH_MS * OVERLAY_GRAPH_HEIGHT;
+		setQuad(&graph[(PROFILE_HISTORY + i) * 4], left, top, OVERLAY_WIDTH, 1, sf::Color(255, 255, 255, 128));
+	}
+
+	long long frames = FrameProfiler::instance().getFrameCount();
+	if (textFrame < 0 || frames - textFrame >= OVERLAY_TEXT_REFRESH)
+	{
+		updateText();
+		textFrame = frames;
+	}
+
+	target.draw(panel);
+	target.draw(graph);
+	target.draw(text);
+}
+
+/*****************************************************************************************************************
+ *										updateText()															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Lays out the p50/p95/p99 of every phase in milliseconds.										 *
+ ****************************************************************************************************************/
+void ProfilerOverlay::updateText()
+{
+	std::ostringstream table;
+	table << std::fixed << std::setprecision(3);
+	table << "ms                    p50       p95       p99\n";
+	for (int phase = 0; phase < Phase::Count; phase++)
+	{
+		PhaseStats stats = FrameProfiler::instance().getStats(static_cast<Phase::ID>(phase));
+		table << std::left << std::setw(18) << phaseName(static_cast<Phase::ID>(phase)) << std::right
+			<< std::setw(10) << stats.p50Ms << std::setw(10) << stats.p95Ms << std::setw(10) << stats.p99Ms << '\n';
+	}
+	text.setString(table.str());
+}
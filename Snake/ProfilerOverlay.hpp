@@ -0,0 +1,36 @@
+#ifndef PROFILEROVERLAY_HPP
+#define PROFILEROVERLAY_HPP
+
+#include <SFML/Graphics.hpp>
+
+#include "FrameProfiler.hpp"
+
+// Size of the overlay panel in pixels and the frame time shown at the top of its graph
+#define OVERLAY_WIDTH 480
+#define OVERLAY_HEIGHT 380
+#define OVERLAY_GRAPH_HEIGHT 120
+#define OVERLAY_GRAPH_MS 50.0f
+// Frames between two updates of the overlay's text, so the text is not laid out again every frame
+#define OVERLAY_TEXT_REFRESH 30
+
+// Frame time graph and per phase percentiles of the FrameProfiler, drawn over the top right of the game
+class ProfilerOverlay
+{
+	public:
+								ProfilerOverlay(sf::RenderTarget& target, const sf::Font& font);
+		void					toggle();
+		bool					isVisible() const;
+		void					render();
+
+	private:
+		void					updateText();
+
+	private:
+		sf::RenderTarget&		target;
+		bool					visible;
+		long long				textFrame;
+		sf::RectangleShape		panel;
+		sf::VertexArray			graph;
+		sf::Text				text;
+};
+#endif
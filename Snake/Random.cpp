@@ -0,0 +1,75 @@
+#include "Random.hpp"
+
+// Multiplier of the 64 bit linear congruential generator underneath PCG32
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: std::uint64_t seed and std::uint64_t sequence															 *
+ * Output: None																									 *
+ * Description: Random is a PCG32 generator: 16 bytes of state, a handful of instructions per number and good    *
+ * statistical quality. Every game owns one, so seeded runs are reproducible and games on different threads      *
+ * never share a generator. Generators with the same seed but different sequences produce independent streams. *
+ ****************************************************************************************************************/
+Random::Random(std::uint64_t seed, std::uint64_t sequence)
+{
+	this->seed(seed, sequence);
+}
+
+/*****************************************************************************************************************
+ *										seed()   																 *
+ *****************************************************************************************************************
+ * Input: std::uint64_t seed and std::uint64_t sequence															 *
+ * Output: None																									 *
+ * Description: Restarts the generator, following the reference PCG32 seeding.									 *
+ ****************************************************************************************************************/
+void Random::seed(std::uint64_t seed, std::uint64_t sequence)
+{
+	state = 0;
+	increment = (sequence << 1) | 1;
+	next();
+	state += seed;
+	next();
+}
+
+/*****************************************************************************************************************
+ *										next()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: std::uint32_t uniformly distributed random number													 *
+ * Description: Advances the generator and returns the next 32 bits (xorshift and random rotation of the old     *
+ * state).																										 *
+ ****************************************************************************************************************/
+std::uint32_t Random::next()
+{
+	std::uint64_t old = state;
+	state = old * PCG_MULTIPLIER + increment;
+	std::uint32_t shifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+	std::uint32_t rotation = static_cast<std::uint32_t>(old >> 59);
+	return (shifted >> rotation) | (shifted << ((0u - rotation) & 31));
+}
+
+/*****************************************************************************************************************
+ *										nextBelow()   															 *
+ *****************************************************************************************************************
+ * Input: std::uint32_t bound, which must not be 0																 *
+ * Output: std::uint32_t uniformly distributed random number in [0, bound)										 *
+ * Description: Maps a random number onto the range with a multiply instead of a division, rejecting the few     *
+ * values that would make the result biased.																	 *
+ ****************************************************************************************************************/
+std::uint32_t Random::nextBelow(std::uint32_t bound)
+{
+	std::uint64_t product = static_cast<std::uint64_t>(next()) * bound;
+	std::uint32_t low = static_cast<std::uint32_t>(product);
+	if (low < bound)
+	{
+		std::uint32_t threshold = (0u - bound) % bound;
+		while (low < threshold)
+		{
+			product = static_cast<std::uint64_t>(next()) * bound;
+			low = static_cast<std::uint32_t>(product);
+		}
+	}
+	return static_cast<std::uint32_t>(product >> 32);
+}
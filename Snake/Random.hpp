@@ -0,0 +1,18 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+
+class Random
+{
+	public:
+		explicit				Random(std::uint64_t seed = 0, std::uint64_t sequence = 0);
+		void					seed(std::uint64_t seed, std::uint64_t sequence = 0);
+		std::uint32_t			next();
+		std::uint32_t			nextBelow(std::uint32_t bound);
+
+	private:
+		std::uint64_t			state;
+		std::uint64_t			increment;
+};
+#endif
@@ -0,0 +1,389 @@
+#include "Replay.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	void writeVarint(std::vector<std::uint8_t>& bytes, std::uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		bytes.push_back(static_cast<std::uint8_t>(value));
+	}
+
+	// Reads one varint, returning false if the input ends in the middle of it
+	bool readVarint(const std::uint8_t*& position, const std::uint8_t* end, std::uint64_t& value)
+	{
+		value = 0;
+		for (int shift = 0; position != end && shift < 64; shift += 7)
+		{
+			std::uint8_t byte = *position++;
+			value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+/*****************************************************************************************************************
+ *										ReplayCursor															 *
+ *****************************************************************************************************************
+ * Input: pointer to and size of the encoded inputs																 *
+ * Output: None																									 *
+ * Description: Walks the inputs of a replay in tick order. Every input is a single varint holding the number of *
+ * ticks since the previous input shifted left by two, with the Direction in the two low bits, so an input made  *
+ * within 31 ticks of the previous one takes one byte. The cursor is a few pointers and can be copied freely.   *
+ ****************************************************************************************************************/
+ReplayCursor::ReplayCursor(const std::uint8_t* inputs, std::size_t size) : position(inputs), end(inputs + size),
+hasNext(false), nextTick(0), nextDirection(STARTING_DIRECTION), current(STARTING_DIRECTION)
+{
+	readNext();
+}
+
+void ReplayCursor::readNext()
+{
+	std::uint64_t value;
+	hasNext = readVarint(position, end, value);
+	if (hasNext)
+	{
+		nextTick += value >> 2;
+		nextDirection = static_cast<Direction>(value & 3);
+	}
+}
+
+/*****************************************************************************************************************
+ *										directionAt()															 *
+ *****************************************************************************************************************
+ * Input: unsigned long long tick, never smaller than the tick of the previous call								 *
+ * Output: Direction the player had chosen at that tick															 *
+ * Description: Consumes every input up to and including the tick. The direction stays in effect until the next *
+ * input, which is why only changes of direction are stored.													 *
+ ****************************************************************************************************************/
+Direction ReplayCursor::directionAt(unsigned long long tick)
+{
+	while (hasNext && nextTick <= tick)
+	{
+		current = nextDirection;
+		readNext();
+	}
+	return current;
+}
+
+/*****************************************************************************************************************
+ *										ReplayRecorder															 *
+ *****************************************************************************************************************
+ * Input: unsigned int seed of the GameCore, int width and int height of the board, int number of rows at the   *
+ * top of the board that were excluded from food																 *
+ * Output: None																									 *
+ * Description: Records the direction fed to the GameCore on every tick of a session. Since the game is         *
+ * deterministic for a given seed, the seed and the changes of direction are all it takes to play the session   *
+ * back exactly.																								 *
+ ****************************************************************************************************************/
+ReplayRecorder::ReplayRecorder(unsigned int seed, int boardWidth, int boardHeight, int hudRows) : lastTick(0),
+lastDirection(STARTING_DIRECTION)
+{
+	std::memset(&header, 0, sizeof(header));
+	header.magic = REPLAY_MAGIC;
+	header.version = REPLAY_VERSION;
+	header.boardWidth = static_cast<std::uint16_t>(boardWidth);
+	header.boardHeight = static_cast<std::uint16_t>(boardHeight);
+	header.hudRows = static_cast<std::uint16_t>(hudRows);
+	header.seed = seed;
+}
+
+/*****************************************************************************************************************
+ *										addWall()																 *
+ *****************************************************************************************************************
+ * Input: int x and int y of a wall of the board																 *
+ * Output: None																									 *
+ * Description: Records a cell the GameCore of the session was given as a wall with GameCore::addWall(). Walls	 *
+ * must be recorded in the order they were added, before the first tick, so playback places the food exactly as	 *
+ * the session did.																								 *
+ ****************************************************************************************************************/
+void ReplayRecorder::addWall(int x, int y)
+{
+	walls.push_back(static_cast<std::uint32_t>(y * header.boardWidth + x));
+	header.wallCount++;
+}
+
+/*****************************************************************************************************************
+ *										record()																 *
+ *****************************************************************************************************************
+ * Input: unsigned long long tick of the session and the Direction fed to the GameCore on that tick			 *
+ * Output: None																									 *
+ * Description: Should be called once per tick, in tick order. Only changes of direction are stored, delta       *
+ * encoded against the previous change.																			 *
+ ****************************************************************************************************************/
+void ReplayRecorder::record(unsigned long long tick, Direction direction)
+{
+	if (direction == lastDirection)
+	{
+		return;
+	}
+
+	writeVarint(inputs, ((tick - lastTick) << 2) | static_cast<std::uint64_t>(direction));
+	lastTick = tick;
+	lastDirection = direction;
+	header.inputCount++;
+}
+
+/*****************************************************************************************************************
+ *										serialize() / save()													 *
+ *****************************************************************************************************************
+ * Input: unsigned long long number of ticks the session lasted (and the file name to save to)					 *
+ * Output: The replay file as bytes / bool indicating if the file was written									 *
+ * Description: Builds the replay file: the ReplayHeader followed by the walls and the encoded inputs.			 *
+ ****************************************************************************************************************/
+std::vector<std::uint8_t> ReplayRecorder::serialize(unsigned long long tickCount) const
+{
+	ReplayHeader finished = header;
+	finished.tickCount = tickCount;
+	finished.inputBytes = static_cast<std::uint32_t>(inputs.size());
+
+	std::size_t wallBytes = walls.size() * sizeof(std::uint32_t);
+	std::vector<std::uint8_t> bytes(sizeof(finished) + wallBytes + inputs.size());
+	std::memcpy(bytes.data(), &finished, sizeof(finished));
+	if (!walls.empty())
+	{
+		std::memcpy(bytes.data() + sizeof(finished), walls.data(), wallBytes);
+	}
+	if (!inputs.empty())
+	{
+		std::memcpy(bytes.data() + sizeof(finished) + wallBytes, inputs.data(), inputs.size());
+	}
+	return bytes;
+}
+
+bool ReplayRecorder::save(const std::string& filename, unsigned long long tickCount) const
+{
+	std::vector<std::uint8_t> bytes = serialize(tickCount);
+	std::ofstream file(filename, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	return static_cast<bool>(file);
+}
+
+/*****************************************************************************************************************
+ *										Replay																	 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: A Replay is a view of a replay file. Files are memory mapped and used in place: opening one only *
+ * checks the header, so scanning the headers of thousands of replays costs no parsing.							 *
+ ****************************************************************************************************************/
+Replay::Replay() : walls(nullptr), inputs(nullptr)
+{
+	std::memset(&header, 0, sizeof(header));
+}
+
+/*****************************************************************************************************************
+ *										open()																	 *
+ *****************************************************************************************************************
+ * Input: std::string& indicating the file name, or the bytes of a replay that outlive the Replay				 *
+ * Output: bool indicating if the data holds a valid replay														 *
+ * Description: Checks the magic number, the version, the board size, that every wall and input byte is present	 *
+ * and that every wall lies on the board and off the starting snake, so addWallsTo() never gives a core a wall	 *
+ * it cannot start with.																						 *
+ ****************************************************************************************************************/
+bool Replay::open(const std::string& filename)
+{
+	return file.open(filename) && open(file.getData(), file.getSize());
+}
+
+bool Replay::open(const std::uint8_t* data, std::size_t size)
+{
+	walls = nullptr;
+	inputs = nullptr;
+	if (data == nullptr || size < sizeof(header))
+	{
+		return false;
+	}
+
+	std::memcpy(&header, data, sizeof(header));
+	if (header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION ||
+		!isPlayableBoard(header.boardWidth, header.boardHeight) || header.boardHeight <= header.hudRows ||
+		(size - sizeof(header)) / sizeof(std::uint32_t) < header.wallCount ||
+		size - sizeof(header) - header.wallCount * sizeof(std::uint32_t) < header.inputBytes)
+	{
+		return false;
+	}
+
+	walls = data + sizeof(header);
+	for (std::uint32_t i = 0; i < header.wallCount; i++)
+	{
+		std::uint32_t cell;
+		std::memcpy(&cell, walls + i * sizeof(cell), sizeof(cell));
+		if (cell >= static_cast<std::uint32_t>(header.boardWidth) * header.boardHeight ||
+			isStartingCell(header.boardWidth, header.boardHeight, static_cast<int>(cell % header.boardWidth),
+			static_cast<int>(cell / header.boardWidth)))
+		{
+			return false;
+		}
+	}
+	inputs = walls + header.wallCount * sizeof(std::uint32_t);
+	return true;
+}
+
+/*****************************************************************************************************************
+ *										Getters 																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: The header / a cursor over the inputs of the replay													 *
+ * Description: Generic getter functions. Only valid after open() succeeded.									 *
+ ****************************************************************************************************************/
+const ReplayHeader& Replay::getHeader() const
+{
+	return header;
+}
+
+ReplayCursor Replay::getInputs() const
+{
+	return ReplayCursor(inputs, header.inputBytes);
+}
+
+/*****************************************************************************************************************
+ *										addWallsTo()															 *
+ *****************************************************************************************************************
+ * Input: GameCore to play the replay with, on the board of the replay											 *
+ * Output: None																									 *
+ * Description: Gives the core the walls the session was recorded with, in the order they were recorded. Call	 *
+ * it after the HUD rows were excluded from food and before the first tick, as the recording game did.			 *
+ ****************************************************************************************************************/
+void Replay::addWallsTo(GameCore& core) const
+{
+	for (std::uint32_t i = 0; i < header.wallCount; i++)
+	{
+		std::uint32_t cell;
+		std::memcpy(&cell, walls + i * sizeof(cell), sizeof(cell));
+		core.addWall(static_cast<int>(cell % header.boardWidth), static_cast<int>(cell / header.boardWidth));
+	}
+}
+
+/*****************************************************************************************************************
+ *										ReplayPlayer															 *
+ *****************************************************************************************************************
+ * Input: Replay to play, which must outlive the player															 *
+ * Output: None																									 *
+ * Description: Plays a replay back without a window, as fast as the GameCore runs. It applies exactly the rules *
+ * of Game::update (step, then reset a finished game) so the session is reproduced bit for bit. A snapshot of    *
+ * the core is kept every KEYFRAME_INTERVAL ticks the first time playback passes them, so seeking restores the   *
+ * nearest keyframe and only re-simulates the ticks after it.													 *
+ ****************************************************************************************************************/
+ReplayPlayer::ReplayPlayer(const Replay& replay) : core(replay.getHeader().boardWidth, replay.getHeader().boardHeight,
+replay.getHeader().seed), cursor(replay.getInputs()), tick(0), tickCount(replay.getHeader().tickCount)
+{
+	for (int y = 0; y < replay.getHeader().hudRows; y++)
+	{
+		for (int x = 0; x < core.getBoardWidth(); x++)
+		{
+			core.excludeFromFood(x, y);
+		}
+	}
+	replay.addWallsTo(core);
+
+	addKeyframe();
+}
+
+/*****************************************************************************************************************
+ *										step()																	 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: bool indicating if a tick was played, false at the end of the replay									 *
+ * Description: Plays the next tick of the session.																 *
+ ****************************************************************************************************************/
+bool ReplayPlayer::step()
+{
+	if (tick >= tickCount)
+	{
+		return false;
+	}
+
+	core.step(cursor.directionAt(tick));
+	if (core.isGameOver())
+	{
+		core.reset();
+	}
+	tick++;
+
+	if (tick % KEYFRAME_INTERVAL == 0 && tick / KEYFRAME_INTERVAL == keyframes.size())
+	{
+		addKeyframe();
+	}
+	return true;
+}
+
+/*****************************************************************************************************************
+ *										addKeyframe()															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Stores a snapshot of the core and the input cursor at the current tick.							 *
+ ****************************************************************************************************************/
+void ReplayPlayer::addKeyframe()
+{
+	Keyframe keyframe = { tick, GameSnapshot(), cursor };
+	core.snapshot(keyframe.snapshot);
+	keyframes.push_back(keyframe);
+}
+
+/*****************************************************************************************************************
+ *										seek()																	 *
+ *****************************************************************************************************************
+ * Input: unsigned long long tick to move to, clamped to the length of the replay								 *
+ * Output: None																									 *
+ * Description: Moves playback to the tick, backwards or forwards. Playback restarts from the closest keyframe   *
+ * unless the current tick is already closer.																	 *
+ ****************************************************************************************************************/
+void ReplayPlayer::seek(unsigned long long target)
+{
+	if (target > tickCount)
+	{
+		target = tickCount;
+	}
+
+	std::size_t index = static_cast<std::size_t>(target / KEYFRAME_INTERVAL);
+	if (index >= keyframes.size())
+	{
+		index = keyframes.size() - 1;
+	}
+	const Keyframe& keyframe = keyframes[index];
+	if (tick > target || tick < keyframe.tick)
+	{
+		tick = keyframe.tick;
+		core.restore(keyframe.snapshot);
+		cursor = keyframe.cursor;
+	}
+
+	while (tick < target)
+	{
+		step();
+	}
+}
+
+/*****************************************************************************************************************
+ *										Getters 																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: The requested part of the playback state																 *
+ * Description: Generic getter functions. The core shows the game as it was after getTick() ticks.			 *
+ ****************************************************************************************************************/
+const GameCore& ReplayPlayer::getCore() const
+{
+	return core;
+}
+
+unsigned long long ReplayPlayer::getTick() const
+{
+	return tick;
+}
+
+unsigned long long ReplayPlayer::getTickCount() const
+{
+	return tickCount;
+}
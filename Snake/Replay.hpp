@@ -0,0 +1,117 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameCore.hpp"
+#include "MappedFile.hpp"
+
+// "SNKR" read as a little endian 32 bit number
+#define REPLAY_MAGIC 0x524B4E53u
+#define REPLAY_VERSION 3
+// Ticks between two keyframes kept by a ReplayPlayer for seeking
+#define KEYFRAME_INTERVAL 4096
+
+// Fixed size header at the start of every replay file, followed by wallCount 32 bit cell indices (y * width + x) of
+// the walls of the board and inputBytes bytes of varint encoded inputs. Fields are stored little endian, so a mapped
+// file can be read in place on the platforms the game ships on
+struct ReplayHeader
+{
+	std::uint32_t			magic;
+	std::uint16_t			version;
+	std::uint16_t			boardWidth;
+	std::uint16_t			boardHeight;
+	std::uint16_t			hudRows;
+	std::uint32_t			seed;
+	std::uint64_t			tickCount;
+	std::uint32_t			inputCount;
+	std::uint32_t			inputBytes;
+	std::uint32_t			wallCount;
+	std::uint32_t			reserved;
+};
+static_assert(sizeof(ReplayHeader) == 40, "ReplayHeader must match the file layout");
+
+class ReplayCursor
+{
+	public:
+								ReplayCursor(const std::uint8_t* inputs, std::size_t size);
+		Direction				directionAt(unsigned long long tick);
+
+	private:
+		void					readNext();
+
+	private:
+		const std::uint8_t*		position;
+		const std::uint8_t*		end;
+		bool					hasNext;
+		unsigned long long		nextTick;
+		Direction				nextDirection;
+		Direction				current;
+};
+
+class ReplayRecorder
+{
+	public:
+								ReplayRecorder(unsigned int seed, int boardWidth, int boardHeight, int hudRows);
+		void					addWall(int x, int y);
+		void					record(unsigned long long tick, Direction direction);
+		std::vector<std::uint8_t>	serialize(unsigned long long tickCount) const;
+		bool					save(const std::string& filename, unsigned long long tickCount) const;
+
+	private:
+		ReplayHeader			header;
+		std::vector<std::uint32_t>	walls;
+		std::vector<std::uint8_t>	inputs;
+		unsigned long long		lastTick;
+		Direction				lastDirection;
+};
+
+class Replay
+{
+	public:
+								Replay();
+		bool					open(const std::string& filename);
+		bool					open(const std::uint8_t* data, std::size_t size);
+		const ReplayHeader&		getHeader() const;
+		void					addWallsTo(GameCore& core) const;
+		ReplayCursor			getInputs() const;
+
+	private:
+		MappedFile				file;
+		ReplayHeader			header;
+		const std::uint8_t*		walls;
+		const std::uint8_t*		inputs;
+};
+
+class ReplayPlayer
+{
+	public:
+		explicit				ReplayPlayer(const Replay& replay);
+		bool					step();
+		void					seek(unsigned long long tick);
+		const GameCore&			getCore() const;
+		unsigned long long		getTick() const;
+		unsigned long long		getTickCount() const;
+
+	private:
+		void					addKeyframe();
+
+	private:
+		struct Keyframe
+		{
+			unsigned long long	tick;
+			GameSnapshot		snapshot;
+			ReplayCursor		cursor;
+		};
+
+	private:
+		GameCore				core;
+		ReplayCursor			cursor;
+		unsigned long long		tick;
+		unsigned long long		tickCount;
+		std::vector<Keyframe>	keyframes;
+};
+#endif
@@ -1,26 +1,96 @@
 #include "ResourceHolder.hpp"
 
+#include <chrono>
+#include <thread>
+
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+namespace
+{
+	const char* const kindNames[] = { "Texture", "SoundBuffer", "Music", "Font", "Map" };
+
+	// Worker threads shared by every ResourceHolder. Built on first use, so the headless tools never start them
+	ThreadPool& loaderPool()
+	{
+		static ThreadPool pool(static_cast<int>(std::thread::hardware_concurrency()));
+		return pool;
+	}
+
+	double millisecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// The first asset loaded under an ID stays, since the game holds references to it
+	template <typename Resource>
+	void install(std::unique_ptr<Resource>& slot, std::unique_ptr<Resource>& resource)
+	{
+		if (!slot)
+		{
+			slot = std::move(resource);
+		}
+	}
+}
+
+const AssetPack* ResourceHolder::assetPack = nullptr;
+bool ResourceHolder::logging = true;
+
+/*****************************************************************************************************************
+ *										ResourceError													 *
+ *****************************************************************************************************************
+ * Input: Assets::Kind and ID of the asset, std::string& message												 *
+ * Output: None																									 *
+ * Description: Says which asset could not be handed out and why.												 *
+ ****************************************************************************************************************/
+ResourceError::ResourceError(Assets::Kind kind, int id, const std::string& message) : std::runtime_error(message), kind(kind), id(id)
+{
+}
+
+Assets::Kind ResourceError::getKind() const
+{
+	return kind;
+}
+
+int ResourceError::getId() const
+{
+	return id;
+}
+
 /*****************************************************************************************************************
  *										loadTextures()   														 *
  *****************************************************************************************************************
  * Input: Textures::ID indicating textures name, std::string& indicating the file name							 *
  * Output: None																									 *
- * Description: The following loads textures into a std::map. It is a handy function to keep all textures in one *
- * data structure.																								 *
+ * Description: The following loads a texture into the slot of its ID right away, on the calling thread. It is	 *
+ * a handy function to keep all textures in one data structure. To load several files, queue them and call		 *
+ * loadQueued() instead, which decodes them in parallel.														 *
  ****************************************************************************************************************/
 void ResourceHolder::loadTextures(Textures::ID id, const std::string& filename)
 {
-	std::unique_ptr<sf::Texture> texture(new sf::Texture());
-	if (!texture->loadFromFile(filename))
-	{
-		std::cout << filename << " failed to load" << std::endl;
-	}
-	else
-	{
-		std::cout << filename << " SUCCESFULLY loaded!" << std::endl;
-	}
+	TraceSpan span("loadTextures", "resources", filename.c_str());
+	PendingAsset asset;
+	asset.load = { Assets::Texture, id, filename, false, false, 0.0, 0.0 };
+	decode(asset);
+	finish(asset);
+}
 
-	mTextureMap.insert(std::make_pair(id, std::move(texture)));
+/*****************************************************************************************************************
+ *										loadTextures()   														 *
+ *****************************************************************************************************************
+ * Input: Textures::ID indicating textures name, sf::Image& holding the pixels of the texture					 *
+ * Output: None																									 *
+ * Description: The following loads a texture that was built in memory (such as the sprite sheet) into its slot, *
+ * alongside the textures that were loaded from files.															 *
+ ****************************************************************************************************************/
+void ResourceHolder::loadTextures(Textures::ID id, const sf::Image& image)
+{
+	TraceSpan span("loadTextures", "resources");
+	PendingAsset asset;
+	asset.load = { Assets::Texture, id, "Texture " + std::to_string(id), true, false, 0.0, 0.0 };
+	asset.entry = nullptr;
+	asset.image = image;
+	finish(asset);
 }
 
 /*****************************************************************************************************************
@@ -28,24 +98,15 @@ void ResourceHolder::loadTextures(Textures::ID id, const std::string& filename)
  *****************************************************************************************************************
  * Input: soundBuffers::ID indicating soundBuffer name, std::string& indicating the file name					 *
  * Output: None																									 *
- * Description: The following loads soundBuffers into a std::map. It is a handy function to keep all soundBuffers* 
- * in one data structure.																						 *
+ * Description: The following loads a soundBuffer into the slot of its ID right away, on the calling thread.	 *
  ****************************************************************************************************************/
 void ResourceHolder::loadSoundBuffers(SoundBuffers::ID id, const std::string& filename)
 {
-	std::unique_ptr<sf::SoundBuffer> sound(new sf::SoundBuffer());
-	
-	if (!sound->loadFromFile(filename))
-	{
-		std::cout << filename << " failed to load" << std::endl;
-	}
-	else
-	{
-		std::cout << filename << " SUCCESFULLY loaded!" << std::endl;
-	}
-
-	mSoundBufferMap.insert(std::make_pair(id, std::move(sound)));
-	
+	TraceSpan span("loadSoundBuffers", "resources", filename.c_str());
+	PendingAsset asset;
+	asset.load = { Assets::SoundBuffer, id, filename, false, false, 0.0, 0.0 };
+	decode(asset);
+	finish(asset);
 }
 
 /*****************************************************************************************************************
@@ -53,101 +114,359 @@ void ResourceHolder::loadSoundBuffers(SoundBuffers::ID id, const std::string& fi
  *****************************************************************************************************************
  * Input: Music::ID indicating music name, std::string& indicating the file name							     *
  * Output: None																									 *
- * Description: The following music textures into a std::map. It is a handy function to keep all music in one    *
- * data structure.																								 *
+ * Description: The following opens music into the slot of its ID right away, on the calling thread. Music is	 *
+ * streamed, so only the header of the file is read here.														 *
  ****************************************************************************************************************/
 void ResourceHolder::loadMusic(Music::ID id, const std::string& filename)
 {
-	std::unique_ptr<sf::Music> music(new sf::Music());
+	TraceSpan span("loadMusic", "resources", filename.c_str());
+	PendingAsset asset;
+	asset.load = { Assets::Music, id, filename, false, false, 0.0, 0.0 };
+	decode(asset);
+	finish(asset);
+}
+
+/*****************************************************************************************************************
+ *										loadFont()   														     *
+ *****************************************************************************************************************
+ * Input: Font::ID indicating font name, std::string& indicating the file name							         *
+ * Output: None																									 *
+ * Description: The following loads a font into the slot of its ID right away, on the calling thread.			 *
+ ****************************************************************************************************************/
+void ResourceHolder::loadFonts(Fonts::ID id, const std::string& filename)
+{
+	TraceSpan span("loadFonts", "resources", filename.c_str());
+	PendingAsset asset;
+	asset.load = { Assets::Font, id, filename, false, false, 0.0, 0.0 };
+	decode(asset);
+	finish(asset);
+}
+
+/*****************************************************************************************************************
+ *										queueTextures() / queueSoundBuffers() / queueMusic() / queueFonts()		 *
+ *****************************************************************************************************************
+ * Input: ID of the asset, std::string& indicating the file name												 *
+ * Output: None																									 *
+ * Description: Adds a file to the next loadQueued(). Nothing is read until then.								 *
+ ****************************************************************************************************************/
+void ResourceHolder::queueTextures(Textures::ID id, const std::string& filename)
+{
+	queue(Assets::Texture, id, filename);
+}
+
+void ResourceHolder::queueSoundBuffers(SoundBuffers::ID id, const std::string& filename)
+{
+	queue(Assets::SoundBuffer, id, filename);
+}
+
+void ResourceHolder::queueMusic(Music::ID id, const std::string& filename)
+{
+	queue(Assets::Music, id, filename);
+}
+
+void ResourceHolder::queueFonts(Fonts::ID id, const std::string& filename)
+{
+	queue(Assets::Font, id, filename);
+}
+
+void ResourceHolder::queue(Assets::Kind kind, int id, const std::string& filename)
+{
+	std::unique_ptr<PendingAsset> asset(new PendingAsset());
+	asset->load = { kind, id, filename, false, false, 0.0, 0.0 };
+	mQueue.push_back(std::move(asset));
+}
 
-	if (!music->openFromFile(filename))
+/*****************************************************************************************************************
+ *										loadQueued()   															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: bool indicating if every queued asset loaded															 *
+ * Description: Decodes every queued file at once on the loader threads: PNG to pixels, WAV to samples, the OGG	 *
+ * header and the TTF face. Textures are then uploaded to the graphics card here, on the calling thread, which	 *
+ * owns the OpenGL context. The time of every asset goes to the load report, and the ones that failed leave	 *
+ * their slot empty, so asking for them throws a ResourceError.													 *
+ ****************************************************************************************************************/
+bool ResourceHolder::loadQueued()
+{
+	TraceSpan span("loadQueued", "resources");
+	ThreadPool& pool = loaderPool();
+	for (std::unique_ptr<PendingAsset>& asset : mQueue)
 	{
-		std::cout << filename << " failed to load" << std::endl;
+		PendingAsset* pending = asset.get();
+		pool.submit([pending] { decode(*pending); });
 	}
-	else
+	pool.wait();
+
+	bool allLoaded = true;
+	for (std::unique_ptr<PendingAsset>& asset : mQueue)
 	{
-		std::cout << filename << " SUCCESFULLY loaded!" << std::endl;
+		finish(*asset);
+		allLoaded = allLoaded && asset->load.loaded;
 	}
-
-	mMusicMap.insert(std::make_pair(id, std::move(music)));
-
+	mQueue.clear();
+	return allLoaded;
 }
 
 /*****************************************************************************************************************
- *										loadFont()   														     *
+ *										decode()   																 *
  *****************************************************************************************************************
- * Input: Font::ID indicating font name, std::string& indicating the file name							         *
+ * Input: PendingAsset to read from its file																	 *
  * Output: None																									 *
- * Description: The following loads fonts into a std::map. It is a handy function to keep all fonts in one	     *
- * data structure.																								 *
+ * Description: Everything that does not need the graphics context. Safe to run on any thread, one per asset.	 *
+ * An asset held by the asset pack is read in place from the mapped pack instead of from its loose file.		 *
  ****************************************************************************************************************/
-void ResourceHolder::loadFonts(Fonts::ID id, const std::string& filename)
+void ResourceHolder::decode(PendingAsset& asset)
 {
-	std::unique_ptr<sf::Font> font(new sf::Font());
-	if (!font->loadFromFile(filename))
+	TraceSpan span("decode", "resources", asset.load.filename.c_str());
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	asset.entry = assetPack ? assetPack->find(asset.load.filename) : nullptr;
+	asset.load.packed = asset.entry != nullptr;
+	const std::uint8_t* bytes = asset.entry ? assetPack->getData(*asset.entry) : nullptr;
+	std::size_t size = asset.entry ? static_cast<std::size_t>(asset.entry->size) : 0;
+	switch (asset.load.kind)
 	{
-		std::cout << filename << " failed to load" << std::endl;
+		case Assets::Texture:
+		{
+			if (asset.entry && asset.entry->format == PackFormat::Rgba)
+			{
+				// Already pixels: finish() uploads them straight from the pack
+				asset.load.loaded = true;
+			}
+			else
+			{
+				asset.load.loaded = bytes ? asset.image.loadFromMemory(bytes, size) : asset.image.loadFromFile(asset.load.filename);
+			}
+			break;
+		}
+		case Assets::SoundBuffer:
+		{
+			asset.soundBuffer = std::unique_ptr<sf::SoundBuffer>(new sf::SoundBuffer());
+			asset.load.loaded = bytes ? asset.soundBuffer->loadFromMemory(bytes, size) : asset.soundBuffer->loadFromFile(asset.load.filename);
+			break;
+		}
+		case Assets::Music:
+		{
+			// Streams from the pack while it plays, which is why the pack stays open for the whole run
+			asset.music = std::unique_ptr<sf::Music>(new sf::Music());
+			asset.load.loaded = bytes ? asset.music->openFromMemory(bytes, size) : asset.music->openFromFile(asset.load.filename);
+			break;
+		}
+		case Assets::Font:
+		{
+			asset.font = std::unique_ptr<sf::Font>(new sf::Font());
+			asset.load.loaded = bytes ? asset.font->loadFromMemory(bytes, size) : asset.font->loadFromFile(asset.load.filename);
+			break;
+		}
+		case Assets::Map:
+		{
+			// Maps are read by TileMap, a queued one has no slot to go to
+			asset.load.loaded = false;
+			break;
+		}
 	}
-	else
+	asset.load.decodeMs = millisecondsSince(start);
+}
+
+/*****************************************************************************************************************
+ *										finish()   																 *
+ *****************************************************************************************************************
+ * Input: PendingAsset that was decoded																			 *
+ * Output: None																									 *
+ * Description: Uploads a texture, puts the asset into the slot of its ID and reports it. The report is written	 *
+ * with '\n' rather than std::endl, so loading a batch does not flush the console once per asset.				 *
+ ****************************************************************************************************************/
+void ResourceHolder::finish(PendingAsset& asset)
+{
+	if (asset.load.loaded)
 	{
-		std::cout << filename << " SUCCESFULLY loaded!" << std::endl;
+		switch (asset.load.kind)
+		{
+			case Assets::Texture:
+			{
+				TraceSpan span("upload", "resources", asset.load.filename.c_str());
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				std::unique_ptr<sf::Texture> texture(new sf::Texture());
+				if (asset.entry && asset.entry->format == PackFormat::Rgba)
+				{
+					asset.load.loaded = texture->create(asset.entry->width, asset.entry->height);
+					if (asset.load.loaded)
+					{
+						texture->update(assetPack->getData(*asset.entry));
+					}
+				}
+				else
+				{
+					asset.load.loaded = texture->loadFromImage(asset.image);
+				}
+				asset.load.uploadMs = millisecondsSince(start);
+				if (asset.load.loaded)
+				{
+					install(mTextures[asset.load.id], texture);
+				}
+				break;
+			}
+			case Assets::SoundBuffer:
+			{
+				install(mSoundBuffers[asset.load.id], asset.soundBuffer);
+				break;
+			}
+			case Assets::Music:
+			{
+				install(mMusic[asset.load.id], asset.music);
+				break;
+			}
+			case Assets::Font:
+			{
+				install(mFonts[asset.load.id], asset.font);
+				break;
+			}
+			case Assets::Map:
+			{
+				asset.load.loaded = false;
+				break;
+			}
+		}
 	}
 
-	mFontMap.insert(std::make_pair(id, std::move(font)));
+	if (logging && asset.load.loaded)
+	{
+		std::cout << asset.load.filename << (asset.load.packed ? " (pack)" : "") << " loaded in " << asset.load.decodeMs + asset.load.uploadMs << " ms\n";
+	}
+	else if (logging)
+	{
+		std::cout << asset.load.filename << " failed to load\n";
+	}
+	mLoadReport.push_back(asset.load);
 }
 
 /*****************************************************************************************************************
  *										getTextures()   														 *
  *****************************************************************************************************************
- * Input: Textures::ID indicating font name																		 *
- * Output: None																									 *
- * Description: The following function retrieves textures from the map that were stored using the respective     *
- * load function.																								 *
+ * Input: Textures::ID indicating texture name																	 *
+ * Output: sf::Texture& of the ID																				 *
+ * Description: The following function retrieves a texture from its slot, stored using the respective load		 *
+ * function. Throws a ResourceError if the texture never loaded.												 *
  ****************************************************************************************************************/
 sf::Texture& ResourceHolder::getTextures(Textures::ID id)
 {
-	auto found = mTextureMap.find(id);
-	return *found->second;
+	if (!mTextures[id])
+	{
+		throw missing(Assets::Texture, id);
+	}
+	return *mTextures[id];
 }
 
 /*****************************************************************************************************************
  *										getSoundBuffers()   													 *
  *****************************************************************************************************************
- * Input: SoundBuffers::ID indicating font name																	 *
- * Output: None																									 *
- * Description: The following function retrieves soundBuffers from the map that were stored using the respective *
- * load function.																								 *
+ * Input: SoundBuffers::ID indicating soundBuffer name															 *
+ * Output: sf::SoundBuffer& of the ID																			 *
+ * Description: The following function retrieves a soundBuffer from its slot, stored using the respective load	 *
+ * function. Throws a ResourceError if the soundBuffer never loaded.											 *
  ****************************************************************************************************************/
 sf::SoundBuffer& ResourceHolder::getSoundBuffers(SoundBuffers::ID id)
 {
-	auto found = mSoundBufferMap.find(id);
-	return *found->second;
+	if (!mSoundBuffers[id])
+	{
+		throw missing(Assets::SoundBuffer, id);
+	}
+	return *mSoundBuffers[id];
 }
 
 /*****************************************************************************************************************
  *										getMusic()   														     *
  *****************************************************************************************************************
- * Input: Music::ID indicating font name																		 *
- * Output: None																									 *
- * Description: The following function retrieves Music from the map that were stored using the respective        *
- * load function.																								 *
+ * Input: Music::ID indicating music name																		 *
+ * Output: sf::Music& of the ID																					 *
+ * Description: The following function retrieves music from its slot, stored using the respective load function. *
+ * Throws a ResourceError if the music never opened.															 *
  ****************************************************************************************************************/
 sf::Music& ResourceHolder::getMusic(Music::ID id)
 {
-	auto found = mMusicMap.find(id);
-	return *found->second;
+	if (!mMusic[id])
+	{
+		throw missing(Assets::Music, id);
+	}
+	return *mMusic[id];
 }
 
 /*****************************************************************************************************************
  *										getFont()   									   					     *
  *****************************************************************************************************************
  * Input: Font::ID indicating font name																		     *
- * Output: None																									 *
- * Description: The following function retrieves fonts from the map that were stored using the respective        *
- * load function.																								 *
+ * Output: sf::Font& of the ID																					 *
+ * Description: The following function retrieves a font from its slot, stored using the respective load			 *
+ * function. Throws a ResourceError if the font never loaded.													 *
  ****************************************************************************************************************/
 sf::Font& ResourceHolder::getFont(Fonts::ID id)
 {
-	auto found = mFontMap.find(id);
-	return *found->second;
-}
\ No newline at end of file
+	if (!mFonts[id])
+	{
+		throw missing(Assets::Font, id);
+	}
+	return *mFonts[id];
+}
+
+/*****************************************************************************************************************
+ *										missing()   															 *
+ *****************************************************************************************************************
+ * Input: Assets::Kind and ID of an empty slot																	 *
+ * Output: ResourceError to throw																				 *
+ * Description: Tells an asset that failed to load, naming its file, apart from one that was never loaded.		 *
+ ****************************************************************************************************************/
+ResourceError ResourceHolder::missing(Assets::Kind kind, int id) const
+{
+	std::string asset = std::string(kindNames[kind]) + " " + std::to_string(id);
+	for (std::vector<AssetLoad>::const_reverse_iterator load = mLoadReport.rbegin(); load != mLoadReport.rend(); ++load)
+	{
+		if (load->kind == kind && load->id == id)
+		{
+			return ResourceError(kind, id, asset + " failed to load from " + load->filename);
+		}
+	}
+	return ResourceError(kind, id, asset + " was never loaded");
+}
+
+/*****************************************************************************************************************
+ *										getLoadReport()   														 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: std::vector<AssetLoad>& of every asset loaded so far, in the order they finished						 *
+ * Description: Per asset decode and upload times, to see where start up time goes.								 *
+ ****************************************************************************************************************/
+const std::vector<AssetLoad>& ResourceHolder::getLoadReport() const
+{
+	return mLoadReport;
+}
+
+/*****************************************************************************************************************
+ *										setAssetPack() / getAssetPack()											 *
+ *****************************************************************************************************************
+ * Input: AssetPack* to load from, nullptr for loose files only. It must stay open while any asset is in use /	 *
+ * None																											 *
+ * Output: None / the pack set, or nullptr																		 *
+ * Description: Every ResourceHolder loads the files the pack holds from the pack and the rest from Media/. Set	 *
+ * it before loading anything; it is not synchronized with loads in flight. TileMap reads maps from the same	 *
+ * pack.																										 *
+ ****************************************************************************************************************/
+void ResourceHolder::setAssetPack(const AssetPack* pack)
+{
+	assetPack = pack;
+}
+
+const AssetPack* ResourceHolder::getAssetPack()
+{
+	return assetPack;
+}
+
+/*****************************************************************************************************************
+ *										setLogging()															 *
+ *****************************************************************************************************************
+ * Input: bool on to print a line per asset loaded, the default												 *
+ * Output: None																									 *
+ * Description: The load report is kept either way.																 *
+ ****************************************************************************************************************/
+void ResourceHolder::setLogging(bool on)
+{
+	logging = on;
+}
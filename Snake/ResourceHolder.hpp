@@ -2,51 +2,116 @@
 #define RESOURCEHOLDER_HPP
 
 #include <iostream>
-#include <list>
-#include <map>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
 
+#include "AssetPack.hpp"
+
 namespace Textures
 {
-	enum ID { Background, GrassA, Head, MenuExit, MenuNeutral, MenuPlay, TileSet, Torso, Veggies };
+	enum ID { Atlas, Background, GrassA, Head, MenuExit, MenuNeutral, MenuPlay, TileSet, Torso, Veggies, Count };
 }
 
 namespace SoundBuffers
 {
-	enum ID {Death, Hover, Munch };
+	enum ID {Death, Hover, Munch, Count };
 }
 
 namespace Music
 {
-	enum ID {Game, Menu};
+	enum ID {Game, Menu, Count};
 }
 
 namespace Fonts
 {
-	enum ID {Bauhaus};
+	enum ID {Bauhaus, Count};
+}
+
+// Maps are read by TileMap rather than the ResourceHolder, but fail with the same ResourceError
+namespace Assets
+{
+	enum Kind { Texture, SoundBuffer, Music, Font, Map };
 }
 
+// How long one asset took: decoding the file (on a worker thread for queued assets) and uploading it to the
+// graphics card on the calling thread, which only textures do. Packed assets were read from the asset pack
+struct AssetLoad
+{
+	Assets::Kind			kind;
+	int						id;
+	std::string				filename;
+	bool					loaded;
+	bool					packed;
+	double					decodeMs;
+	double					uploadMs;
+};
+
+// Thrown when an asset is asked for that was never loaded or failed to load
+class ResourceError : public std::runtime_error
+{
+	public:
+								ResourceError(Assets::Kind kind, int id, const std::string& message);
+		Assets::Kind			getKind() const;
+		int						getId() const;
+
+	private:
+		Assets::Kind			kind;
+		int						id;
+};
+
 class ResourceHolder : public sf::NonCopyable
 {
 	public:
 		void				loadTextures(Textures::ID id, const std::string& filename);
+		void				loadTextures(Textures::ID id, const sf::Image& image);
 		void				loadSoundBuffers(SoundBuffers::ID id, const std::string& filename);
 		void				loadMusic(Music::ID id, const std::string& filename);
 		void				loadFonts(Fonts::ID id, const std::string& filename);
+		void				queueTextures(Textures::ID id, const std::string& filename);
+		void				queueSoundBuffers(SoundBuffers::ID id, const std::string& filename);
+		void				queueMusic(Music::ID id, const std::string& filename);
+		void				queueFonts(Fonts::ID id, const std::string& filename);
+		bool				loadQueued();
 		sf::Texture&		getTextures(Textures::ID id);
 		sf::SoundBuffer&	getSoundBuffers(SoundBuffers::ID id);
 		sf::Music&			getMusic(Music::ID id);
 		sf::Font&			getFont(Fonts::ID id);
+		const std::vector<AssetLoad>&	getLoadReport() const;
+		static void			setAssetPack(const AssetPack* pack);
+		static const AssetPack*	getAssetPack();
+		static void			setLogging(bool on);
 
 	private:
-		std::map<Textures::ID, std::unique_ptr<sf::Texture>>			mTextureMap;
-		std::map<SoundBuffers::ID, std::unique_ptr<sf::SoundBuffer>>	mSoundBufferMap;
-		std::map<Music::ID, std::unique_ptr<sf::Music>>					mMusicMap;
-		std::map<Fonts::ID, std::unique_ptr<sf::Font>>					mFontMap;
+		// An asset on its way in. The worker thread only touches its own PendingAsset
+		struct PendingAsset
+		{
+			AssetLoad							load;
+			const PackEntry*					entry;
+			sf::Image							image;
+			std::unique_ptr<sf::SoundBuffer>	soundBuffer;
+			std::unique_ptr<sf::Music>			music;
+			std::unique_ptr<sf::Font>			font;
+		};
 
+	private:
+		void				queue(Assets::Kind kind, int id, const std::string& filename);
+		static void			decode(PendingAsset& asset);
+		void				finish(PendingAsset& asset);
+		ResourceError		missing(Assets::Kind kind, int id) const;
 
+	private:
+		std::unique_ptr<sf::Texture>					mTextures[Textures::ID::Count];
+		std::unique_ptr<sf::SoundBuffer>				mSoundBuffers[SoundBuffers::ID::Count];
+		std::unique_ptr<sf::Music>						mMusic[Music::ID::Count];
+		std::unique_ptr<sf::Font>						mFonts[Fonts::ID::Count];
+		std::vector<std::unique_ptr<PendingAsset>>		mQueue;
+		std::vector<AssetLoad>							mLoadReport;
+		static const AssetPack*							assetPack;
+		static bool										logging;
 };
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,244 @@
+#include "Scenario.hpp"
+
+#include <chrono>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+	#include <psapi.h>
+	#pragma comment(lib, "psapi.lib")
+#else
+	#include <sys/resource.h>
+#endif
+
+namespace
+{
+	double secondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void clearReport(const std::string& name, ScenarioReport& report)
+	{
+		report.name = name;
+		report.frames = 0;
+		report.ticks = 0;
+		report.score = 0;
+		report.loadSeconds = 0.0;
+		report.processEventsSeconds = 0.0;
+		report.updateSeconds = 0.0;
+		report.renderSeconds = 0.0;
+		report.peakResidentBytes = 0;
+	}
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: bool offscreen to draw into a texture instead of a window, int ticks run per rendered frame			 *
+ * Output: None																									 *
+ * Description: The ScenarioRunner plays scripted sessions through the real Game and Menu states and times the   *
+ * phases of their run loops apart. It replaces only the clock: each frame processes the events, runs a fixed	 *
+ * number of ticks through Game::update() and renders, as fast as the machine allows. Offscreen, the states draw *
+ * into a texture the size of the game window and the window is never opened, so the cost of rendering is		 *
+ * measured on machines without a display too.																	 *
+ ****************************************************************************************************************/
+ScenarioRunner::ScenarioRunner(bool offscreen, int ticksPerFrame) : offscreen(offscreen), ticksPerFrame(ticksPerFrame), ready(false)
+{
+	if (offscreen)
+	{
+		ready = texture.create(SCENARIO_WIDTH, SCENARIO_HEIGHT);
+	}
+	else
+	{
+		window.create(sf::VideoMode(SCENARIO_WIDTH, SCENARIO_HEIGHT, 32), "Snake scenario");
+		ready = window.isOpen();
+	}
+}
+
+/*****************************************************************************************************************
+ *										isReady()																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: bool true if the window opened or the offscreen texture was created									 *
+ * Description: Getter function.																				 *
+ ****************************************************************************************************************/
+bool ScenarioRunner::isReady() const
+{
+	return ready;
+}
+
+/*****************************************************************************************************************
+ *										runTrace()																 *
+ *****************************************************************************************************************
+ * Input: std::string name of the scenario, Replay holding the input trace, ScenarioReport to fill				 *
+ * Output: None																									 *
+ * Description: Builds a Game that plays the trace, the same way Snake --replay does, and runs it until every	 *
+ * tick of the trace has gone through Game::update().															 *
+ ****************************************************************************************************************/
+void ScenarioRunner::runTrace(const std::string& name, const Replay& trace, ScenarioReport& report)
+{
+	clearReport(name, report);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Game game(window, trace, offscreen ? &texture : nullptr);
+	report.loadSeconds = secondsSince(start);
+
+	playFrames(game, trace.getHeader().tickCount, report);
+	report.peakResidentBytes = peakResidentBytes();
+}
+
+/*****************************************************************************************************************
+ *										runMenuTransition()														 *
+ *****************************************************************************************************************
+ * Input: int frames shown by the menu, Replay holding the input trace of the game, ScenarioReport to fill		 *
+ * Output: None																									 *
+ * Description: Loads the menu, shows it for a number of frames, then clicks Play and loads the game, which		 *
+ * plays the trace. The menu reads the mouse straight from the desktop, so the click is scripted by leaving		 *
+ * the menu state the way the Play button does rather than by a recorded mouse event.							 *
+ ****************************************************************************************************************/
+void ScenarioRunner::runMenuTransition(int menuFrames, const Replay& trace, ScenarioReport& report)
+{
+	clearReport("menu to game", report);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::unique_ptr<Menu> menu(new Menu(window, offscreen ? &texture : nullptr));
+	report.loadSeconds = secondsSince(start);
+
+	for (int frame = 0; frame < menuFrames; frame++)
+	{
+		start = std::chrono::steady_clock::now();
+		menu->processEvents();
+		report.processEventsSeconds += secondsSince(start);
+
+		start = std::chrono::steady_clock::now();
+		menu->update();
+		report.updateSeconds += secondsSince(start);
+
+		start = std::chrono::steady_clock::now();
+		menu->render();
+		report.renderSeconds += secondsSince(start);
+		report.frames++;
+	}
+
+	start = std::chrono::steady_clock::now();
+	menu->inMenu = false;
+	menu.reset();
+	Game game(window, trace, offscreen ? &texture : nullptr);
+	report.loadSeconds += secondsSince(start);
+
+	playFrames(game, trace.getHeader().tickCount, report);
+	report.peakResidentBytes = peakResidentBytes();
+}
+
+/*****************************************************************************************************************
+ *										playFrames()															 *
+ *****************************************************************************************************************
+ * Input: Game playing a trace, unsigned long long ticks in the trace, ScenarioReport to add to					 *
+ * Output: None																									 *
+ * Description: The run loop of Game::run() without the clock, each phase timed on its own.						 *
+ ****************************************************************************************************************/
+void ScenarioRunner::playFrames(Game& game, unsigned long long tickCount, ScenarioReport& report)
+{
+	while (game.mTick < tickCount)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		game.processEvents();
+		report.processEventsSeconds += secondsSince(start);
+
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ticksPerFrame && game.mTick < tickCount; i++)
+		{
+			game.update();
+			report.ticks++;
+		}
+		report.updateSeconds += secondsSince(start);
+
+		start = std::chrono::steady_clock::now();
+		game.render();
+		report.renderSeconds += secondsSince(start);
+		report.frames++;
+	}
+	report.score = game.mCore->getScore();
+}
+
+/*****************************************************************************************************************
+ *										recordTrace()															 *
+ *****************************************************************************************************************
+ * Input: Policy playing the game or nullptr for no input, unsigned int seed, int length to grow to or 0, int	 *
+ *        deaths to reach or 0, unsigned long long ticks after which the trace ends regardless					 *
+ * Output: std::vector<std::uint8_t> replay file holding the trace												 *
+ * Description: Plays a game on the board of the game window, with the score rows excluded from food like the	 *
+ * Game does, and records the direction of every tick until the snake reaches the length or has died the		 *
+ * number of times asked for, or the ticks run out. Played back by a Game, the trace reproduces the session		 *
+ * exactly.																										 *
+ ****************************************************************************************************************/
+std::vector<std::uint8_t> recordTrace(Policy* policy, unsigned int seed, int targetLength, int targetDeaths, unsigned long long maxTicks)
+{
+	int width = SCENARIO_WIDTH / BODY_DIMENSIONS;
+	int height = SCENARIO_HEIGHT / BODY_DIMENSIONS;
+	GameCore core(width, height, seed);
+	for (int y = 0; y < HUD_ROWS; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			core.excludeFromFood(x, y);
+		}
+	}
+
+	ReplayRecorder recorder(seed, width, height, HUD_ROWS);
+	unsigned long long tick = 0;
+	int deaths = 0;
+	while (tick < maxTicks)
+	{
+		if ((targetLength > 0 && core.getLength() >= targetLength) || (targetDeaths > 0 && deaths >= targetDeaths))
+		{
+			break;
+		}
+		// Without a policy nobody touches the keyboard and the snake keeps going straight
+		Direction direction = policy ? policy->decide(core) : core.getDirection();
+		recorder.record(tick, direction);
+		if (core.step(direction) & GameEvent::Died)
+		{
+			deaths++;
+		}
+		if (core.isGameOver())
+		{
+			core.reset();
+		}
+		tick++;
+	}
+	return recorder.serialize(tick);
+}
+
+/*****************************************************************************************************************
+ *										peakResidentBytes()														 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: std::size_t largest amount of memory the process has had resident so far								 *
+ * Description: Read from the operating system: the peak working set on Windows, the maximum resident set size  *
+ * elsewhere.																									 *
+ ****************************************************************************************************************/
+std::size_t peakResidentBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return 0;
+	}
+	return counters.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+	#ifdef __APPLE__
+		return static_cast<std::size_t>(usage.ru_maxrss);
+	#else
+		return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+	#endif
+#endif
+}
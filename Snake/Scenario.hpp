@@ -0,0 +1,55 @@
+#ifndef SCENARIO_HPP
+#define SCENARIO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "Game.hpp"
+#include "Menu.hpp"
+#include "Policy.hpp"
+#include "Replay.hpp"
+
+// Size of the window the game is designed for, and of the offscreen texture that stands in for it
+#define SCENARIO_WIDTH 1024
+#define SCENARIO_HEIGHT 896
+
+// Where the time of a scenario went. Loading counts the construction of the Game and Menu states
+struct ScenarioReport
+{
+	std::string				name;
+	long long				frames;
+	long long				ticks;
+	int						score;
+	double					loadSeconds;
+	double					processEventsSeconds;
+	double					updateSeconds;
+	double					renderSeconds;
+	std::size_t				peakResidentBytes;
+};
+
+class ScenarioRunner
+{
+	public:
+								ScenarioRunner(bool offscreen, int ticksPerFrame);
+		bool					isReady() const;
+		void					runTrace(const std::string& name, const Replay& trace, ScenarioReport& report);
+		void					runMenuTransition(int menuFrames, const Replay& trace, ScenarioReport& report);
+
+	private:
+		void					playFrames(Game& game, unsigned long long tickCount, ScenarioReport& report);
+
+	private:
+		bool					offscreen;
+		int						ticksPerFrame;
+		bool					ready;
+		sf::RenderWindow		window;
+		sf::RenderTexture		texture;
+};
+
+std::vector<std::uint8_t>		recordTrace(Policy* policy, unsigned int seed, int targetLength, int targetDeaths, unsigned long long maxTicks);
+std::size_t						peakResidentBytes();
+#endif
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Scenario.hpp"
+
+// Seed of the recorded traces, so every run plays the same sessions
+#define SCENARIO_SEED 1
+#define DEFAULT_GROW_LENGTH 500
+#define DEFAULT_DEATHS 500
+#define DEFAULT_MENU_FRAMES 120
+// Ticks of the game played after the menu in the transition scenario
+#define MENU_GAME_TICKS 600
+// Longest input trace recorded for a scenario, so a policy that never reaches its goal still ends
+#define MAX_TRACE_TICKS 10000000
+
+/*****************************************************************************************************************
+ *										SnakeScenario															 *
+ *****************************************************************************************************************
+ * Macro benchmark of the whole game. Each scenario is an input trace, recorded by a policy before the timing	 *
+ * starts, played through the real Game (and Menu) states frame by frame:										 *
+ *   grow     the hamilton policy grows the snake to --length cells												 *
+ *   deaths   with no input the snake runs into the wall, and the game resets, --deaths times					 *
+ *   menu     the menu shows --menu-frames frames, Play is clicked and the game loads and plays					 *
+ * --trace plays a replay file, such as the LastGame.replay saved by the game, as a scenario of its own.		 *
+ * The report gives ticks/sec, frames/sec, the time spent loading and in processEvents(), update() and render()  *
+ * and the peak resident memory of the process after the scenario.												 *
+ *																												 *
+ * Usage: SnakeScenario [--scenario grow|deaths|menu|all] [--target offscreen|window] [--ticks-per-frame N]		 *
+ *                      [--length L] [--deaths D] [--menu-frames F] [--trace file]								 *
+ *																												 *
+ * The offscreen target (the default) draws into a texture and never opens a window. --ticks-per-frame sets how  *
+ * many ticks run between two rendered frames; the default of 1 renders after every tick.						 *
+ ****************************************************************************************************************/
+
+namespace
+{
+	struct Options
+	{
+		std::string			scenario;
+		bool				offscreen;
+		int					ticksPerFrame;
+		int					length;
+		int					deaths;
+		int					menuFrames;
+		std::string			trace;
+	};
+
+	bool parseOptions(int argc, char* argv[], Options& options)
+	{
+		options.scenario = "all";
+		options.offscreen = true;
+		options.ticksPerFrame = 1;
+		options.length = DEFAULT_GROW_LENGTH;
+		options.deaths = DEFAULT_DEATHS;
+		options.menuFrames = DEFAULT_MENU_FRAMES;
+
+		std::string target = "offscreen";
+		for (int i = 1; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			if (i + 1 >= argc)
+			{
+				std::cerr << "Missing value for " << argument << std::endl;
+				return false;
+			}
+			std::string value = argv[++i];
+
+			if (argument == "--scenario")				options.scenario = value;
+			else if (argument == "--target")			target = value;
+			else if (argument == "--ticks-per-frame")	options.ticksPerFrame = std::atoi(value.c_str());
+			else if (argument == "--length")			options.length = std::atoi(value.c_str());
+			else if (argument == "--deaths")			options.deaths = std::atoi(value.c_str());
+			else if (argument == "--menu-frames")		options.menuFrames = std::atoi(value.c_str());
+			else if (argument == "--trace")				options.trace = value;
+			else
+			{
+				std::cerr << "Unknown option " << argument << std::endl;
+				return false;
+			}
+		}
+
+		if (target != "offscreen" && target != "window")
+		{
+			std::cerr << "Unknown target " << target << std::endl;
+			return false;
+		}
+		options.offscreen = (target == "offscreen");
+		if (options.scenario != "grow" && options.scenario != "deaths" && options.scenario != "menu" && options.scenario != "all")
+		{
+			std::cerr << "Unknown scenario " << options.scenario << std::endl;
+			return false;
+		}
+		if (options.ticksPerFrame < 1)
+		{
+			options.ticksPerFrame = 1;
+		}
+		return true;
+	}
+
+	void printReport(const ScenarioReport& report)
+	{
+		double playSeconds = report.processEventsSeconds + report.updateSeconds + report.renderSeconds;
+		double total = std::max(playSeconds, 1e-9);
+		std::cout << report.name << "\n";
+		std::cout << "  ticks          " << report.ticks << " in " << report.frames << " frames, final score " << report.score << "\n";
+		std::cout << "  ticks/sec      " << report.ticks / total << "\n";
+		std::cout << "  frames/sec     " << report.frames / total << "\n";
+		std::cout << "  load           " << report.loadSeconds * 1e3 << " ms\n";
+		std::cout << "  processEvents  " << std::setw(10) << report.processEventsSeconds * 1e3 << " ms  " << std::setw(6) << 100.0 * report.processEventsSeconds / total << "%\n";
+		std::cout << "  update         " << std::setw(10) << report.updateSeconds * 1e3 << " ms  " << std::setw(6) << 100.0 * report.updateSeconds / total << "%\n";
+		std::cout << "  render         " << std::setw(10) << report.renderSeconds * 1e3 << " ms  " << std::setw(6) << 100.0 * report.renderSeconds / total << "%\n";
+		std::cout << "  peak RSS       " << report.peakResidentBytes / (1024.0 * 1024.0) << " MB\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+
+	ScenarioRunner runner(options.offscreen, options.ticksPerFrame);
+	if (!runner.isReady())
+	{
+		std::cerr << "Could not create the " << (options.offscreen ? "offscreen texture" : "window") << std::endl;
+		return 1;
+	}
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "target " << (options.offscreen ? "offscreen" : "window") << ", " << options.ticksPerFrame << " ticks per frame\n";
+
+	ScenarioReport report;
+	if (!options.trace.empty())
+	{
+		Replay trace;
+		if (!trace.open(options.trace) || trace.getHeader().boardWidth != SCENARIO_WIDTH / BODY_DIMENSIONS ||
+			trace.getHeader().boardHeight != SCENARIO_HEIGHT / BODY_DIMENSIONS || trace.getHeader().hudRows != HUD_ROWS)
+		{
+			std::cerr << options.trace << " is not a replay of this game" << std::endl;
+			return 1;
+		}
+		runner.runTrace(options.trace, trace, report);
+		printReport(report);
+		return 0;
+	}
+
+	if (options.scenario == "grow" || options.scenario == "all")
+	{
+		std::unique_ptr<Policy> policy = createPolicy("hamilton", SCENARIO_SEED);
+		std::vector<std::uint8_t> bytes = recordTrace(policy.get(), SCENARIO_SEED, options.length, 0, MAX_TRACE_TICKS);
+		Replay trace;
+		trace.open(bytes.data(), bytes.size());
+		runner.runTrace("grow to length " + std::to_string(options.length), trace, report);
+		printReport(report);
+	}
+	if (options.scenario == "deaths" || options.scenario == "all")
+	{
+		std::vector<std::uint8_t> bytes = recordTrace(nullptr, SCENARIO_SEED, 0, options.deaths, MAX_TRACE_TICKS);
+		Replay trace;
+		trace.open(bytes.data(), bytes.size());
+		runner.runTrace(std::to_string(options.deaths) + " deaths and resets", trace, report);
+		printReport(report);
+	}
+	if (options.scenario == "menu" || options.scenario == "all")
+	{
+		std::unique_ptr<Policy> policy = createPolicy("autopilot", SCENARIO_SEED);
+		std::vector<std::uint8_t> bytes = recordTrace(policy.get(), SCENARIO_SEED, 0, 0, MENU_GAME_TICKS);
+		Replay trace;
+		trace.open(bytes.data(), bytes.size());
+		runner.runMenuTransition(options.menuFrames, trace, report);
+		printReport(report);
+	}
+	return 0;
+}
@@ -0,0 +1,726 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameCore.hpp"
+#include "Mcts.hpp"
+#include "Policy.hpp"
+#include "Replay.hpp"
+#include "ThreadPool.hpp"
+#include "TranspositionTable.hpp"
+#include "VecSnakeEnv.hpp"
+#include "Zobrist.hpp"
+
+// Games handed to the thread pool per task. Large enough to amortize the task overhead and the policy built for it
+#define GAMES_PER_TASK 64
+// Long enough for the hamilton policy to fill the largest boards
+#define DEFAULT_MAX_TICKS 1000000
+#define DEFAULT_BENCH_STEPS 2000
+// Steps of pre-generated actions cycled through by the benchmarks, so random numbers are not timed
+#define BENCH_ACTION_STEPS 64
+// Random ticks the replay benchmark seeks to
+#define BENCH_SEEKS 100
+// Copies timed per snake length by the snapshot benchmark
+#define BENCH_SNAPSHOTS 10000000
+// Size of the transposition table (2^bits entries) and the probes every thread makes in the table benchmark
+#define BENCH_TABLE_BITS 20
+#define BENCH_TABLE_PROBES 4000000
+
+/*****************************************************************************************************************
+ *										SnakeSim																 *
+ *****************************************************************************************************************
+ * Headless batch simulator. Plays a number of complete games with a policy in place of a player, spread over    *
+ * every core with a work stealing thread pool, and reports throughput and the distribution of scores. It only   *
+ * links the GameCore, so it runs on machines without a display or audio device.								 *
+ *																												 *
+ * Usage: SnakeSim [--games N] [--seed S] [--threads T] [--policy random|greedy|autopilot|hamilton|mcts] *
+ *                 [--width W] [--height H] [--max-ticks M]														 *
+ *       SnakeSim --bench vecenv [--games N] [--steps S] [--seed S] [--width W] [--height H]					 *
+ *       SnakeSim --bench replay [--steps S] [--seed S] [--policy P] [--width W] [--height H]					 *
+ *       SnakeSim --bench snapshot [--seed S] [--policy P] [--width W] [--height H]							 *
+ *       SnakeSim --bench decide [--steps S] [--seed S] [--policy P] [--width W] [--height H]					 *
+ *       SnakeSim --bench mcts [--steps S] [--threads T] [--budget-ms B] [--seed S] [--width W] [--height H]	 *
+ *       SnakeSim --bench ttable [--steps S] [--threads T] [--seed S] [--policy P] [--width W] [--height H]	 *
+ *       SnakeSim --replay file [--seek T]																		 *
+ *																												 *
+ * The vecenv benchmark steps N games for S ticks with random actions, once through VecSnakeEnv and once by     *
+ * looping over N GameCore instances, and reports steps/sec for both on a single thread.						 *
+ * The replay benchmark records a session of S ticks played by the policy, plays it back, checks that playback  *
+ * ends in the recorded state and times seeking to random ticks.												 *
+ * The snapshot benchmark times GameCore::snapshot() and restore() on games the policy played up to several    *
+ * snake lengths.																								 *
+ * The decide benchmark times S decisions of the policy over consecutive games and reports decisions/sec by     *
+ * snake length.																								 *
+ * The mcts benchmark plays S moves with MctsPolicy at a budget of B ms per move, once for 1, 2, 4... up to T    *
+ * search threads, and reports playouts/sec to show how the search scales with cores.							 *
+ * The ttable benchmark checks the incremental Zobrist hash against a full rehash on every tick of S ticks the  *
+ * policy plays, then has 1, 2, 4... up to T threads probe and fill one TranspositionTable with the positions	 *
+ * of those ticks at once, and reports probes/sec and the hit rate.												 *
+ * --replay plays a replay file (such as the LastGame.replay saved by the game) at full speed, or shows the     *
+ * state of the game at tick T.																					 *
+ ****************************************************************************************************************/
+
+namespace
+{
+	struct Options
+	{
+		long long			games;
+		unsigned int		seed;
+		int					threads;
+		std::string			policy;
+		int					width;
+		int					height;
+		long long			maxTicks;
+		std::string			bench;
+		long long			steps;
+		std::string			replay;
+		long long			seek;
+		double				budgetMs;
+	};
+
+	struct GameResult
+	{
+		int					score;
+		int					outcome;
+		long long			ticks;
+	};
+
+	namespace Outcome
+	{
+		enum Type { Died, Won, TimedOut };
+	}
+
+	// Gives every game its own well mixed seed, so results do not depend on how games are split over threads
+	unsigned int gameSeed(unsigned int seed, long long game)
+	{
+		std::uint64_t z = (static_cast<std::uint64_t>(seed) << 32) + static_cast<std::uint64_t>(game) + 0x9E3779B97F4A7C15ULL;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return static_cast<unsigned int>(z ^ (z >> 31));
+	}
+
+	bool parseOptions(int argc, char* argv[], Options& options)
+	{
+		options.games = 10000;
+		options.seed = 1;
+		options.threads = static_cast<int>(std::thread::hardware_concurrency());
+		options.policy = "greedy";
+		options.width = 32;
+		options.height = 28;
+		options.maxTicks = DEFAULT_MAX_TICKS;
+		options.steps = DEFAULT_BENCH_STEPS;
+		options.seek = -1;
+		options.budgetMs = MCTS_DEFAULT_BUDGET * 1000.0;
+
+		for (int i = 1; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			if (i + 1 >= argc)
+			{
+				std::cerr << "Missing value for " << argument << std::endl;
+				return false;
+			}
+			std::string value = argv[++i];
+
+			if (argument == "--games")			options.games = std::atoll(value.c_str());
+			else if (argument == "--seed")		options.seed = static_cast<unsigned int>(std::strtoul(value.c_str(), nullptr, 10));
+			else if (argument == "--threads")	options.threads = std::atoi(value.c_str());
+			else if (argument == "--policy")	options.policy = value;
+			else if (argument == "--width")		options.width = std::atoi(value.c_str());
+			else if (argument == "--height")	options.height = std::atoi(value.c_str());
+			else if (argument == "--max-ticks")	options.maxTicks = std::atoll(value.c_str());
+			else if (argument == "--bench")		options.bench = value;
+			else if (argument == "--steps")		options.steps = std::atoll(value.c_str());
+			else if (argument == "--replay")	options.replay = value;
+			else if (argument == "--seek")		options.seek = std::atoll(value.c_str());
+			else if (argument == "--budget-ms")	options.budgetMs = std::atof(value.c_str());
+			else
+			{
+				std::cerr << "Unknown option " << argument << std::endl;
+				return false;
+			}
+		}
+
+		if (options.threads < 1)
+		{
+			options.threads = 1;
+		}
+		if (!isPlayableBoard(options.width, options.height))
+		{
+			std::cerr << "Board must be at least " << MIN_BOARD_WIDTH << " cells wide and hold at most " << MAX_BOARD_CELLS << " cells" << std::endl;
+			return false;
+		}
+		if (!options.bench.empty() && options.bench != "vecenv" && options.bench != "replay" &&
+			options.bench != "snapshot" && options.bench != "decide" && options.bench != "mcts" && options.bench != "ttable")
+		{
+			std::cerr << "Unknown benchmark " << options.bench << std::endl;
+			return false;
+		}
+		if (!isPolicyName(options.policy))
+		{
+			std::cerr << "Unknown policy " << options.policy << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// Plays games [first, last) and writes one result per game. Runs on a worker thread, with one policy reset for
+	// every game, so an mcts arena is allocated once per task of GAMES_PER_TASK games rather than once per game
+	void playGames(const Options& options, long long first, long long last, std::vector<GameResult>& results)
+	{
+		// The batch already runs on every core, so an mcts search stays on this worker
+		std::unique_ptr<Policy> policy = createPolicy(options.policy, 0, 1);
+		for (long long game = first; game < last; game++)
+		{
+			unsigned int seed = gameSeed(options.seed, game);
+			GameCore core(options.width, options.height, seed);
+			policy->reset(seed ^ 0x5A5A5A5Au);
+
+			GameResult& result = results[static_cast<std::size_t>(game)];
+			result.outcome = Outcome::TimedOut;
+			while (core.getTick() < static_cast<unsigned long long>(options.maxTicks))
+			{
+				int events = core.step(policy->decide(core));
+				if (events & GameEvent::Won)
+				{
+					result.outcome = Outcome::Won;
+					break;
+				}
+				if (events & GameEvent::Died)
+				{
+					result.outcome = Outcome::Died;
+					break;
+				}
+			}
+			result.score = core.getScore();
+			result.ticks = static_cast<long long>(core.getTick());
+		}
+	}
+
+	void printReport(const Options& options, std::vector<GameResult>& results, double seconds)
+	{
+		long long totalTicks = 0;
+		long long outcomes[3] = { 0, 0, 0 };
+		double sum = 0.0;
+		std::vector<int> scores;
+		scores.reserve(results.size());
+
+		for (const GameResult& result : results)
+		{
+			totalTicks += result.ticks;
+			outcomes[result.outcome]++;
+			sum += result.score;
+			scores.push_back(result.score);
+		}
+		std::sort(scores.begin(), scores.end());
+
+		double mean = sum / scores.size();
+		double variance = 0.0;
+		for (int score : scores)
+		{
+			variance += (score - mean) * (score - mean);
+		}
+		double deviation = std::sqrt(variance / scores.size());
+
+		auto percentile = [&scores](double p) { return scores[static_cast<std::size_t>(p * (scores.size() - 1))]; };
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "policy " << options.policy << ", board " << options.width << "x" << options.height
+			<< ", seed " << options.seed << ", threads " << options.threads << "\n";
+		std::cout << "games        " << results.size() << " in " << seconds << " s\n";
+		std::cout << "games/sec    " << results.size() / seconds << "\n";
+		std::cout << "ticks/sec    " << totalTicks / seconds << " (" << totalTicks << " ticks)\n";
+		std::cout << "boards/sec   " << outcomes[Outcome::Won] / seconds << " (games that filled the board)\n";
+		std::cout << "outcomes     died " << outcomes[Outcome::Died] << ", won " << outcomes[Outcome::Won]
+			<< ", timed out " << outcomes[Outcome::TimedOut] << "\n";
+		std::cout << "score        mean " << mean << ", stddev " << deviation << ", min " << scores.front()
+			<< ", p50 " << percentile(0.50) << ", p90 " << percentile(0.90) << ", p99 " << percentile(0.99)
+			<< ", max " << scores.back() << "\n";
+
+		// Histogram of scores in ten equal buckets
+		int buckets = 10;
+		int width = std::max(1, (scores.back() - scores.front()) / buckets + 1);
+		std::vector<long long> histogram(buckets, 0);
+		for (int score : scores)
+		{
+			histogram[std::min(buckets - 1, (score - scores.front()) / width)]++;
+		}
+		for (int i = 0; i < buckets; i++)
+		{
+			int low = scores.front() + i * width;
+			std::cout << "  " << std::setw(5) << low << " - " << std::setw(5) << low + width - 1 << "  "
+				<< std::setw(10) << histogram[i] << "  " << std::string(static_cast<std::size_t>(50.0 * histogram[i] / results.size()), '#') << "\n";
+		}
+	}
+
+	// Compares everything a replay must reproduce: the body, the food, the direction and the counters
+	bool sameState(const GameCore& left, const GameCore& right)
+	{
+		if (left.getTick() != right.getTick() || left.getLength() != right.getLength() || left.getFood() != right.getFood() ||
+			left.getDirection() != right.getDirection() || left.getBody().size() != right.getBody().size())
+		{
+			return false;
+		}
+		for (int i = 0; i < left.getBody().size(); i++)
+		{
+			if (left.getBody()[i] != right.getBody()[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Records a policy session, plays it back and times seeking
+	void benchReplay(const Options& options)
+	{
+		GameCore core(options.width, options.height, options.seed);
+		std::unique_ptr<Policy> policy = createPolicy(options.policy, options.seed ^ 0x5A5A5A5Au);
+		ReplayRecorder recorder(options.seed, options.width, options.height, 0);
+		long long games = 1;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (long long tick = 0; tick < options.steps; tick++)
+		{
+			Direction direction = policy->decide(core);
+			recorder.record(static_cast<unsigned long long>(tick), direction);
+			core.step(direction);
+			if (core.isGameOver())
+			{
+				core.reset();
+				games++;
+			}
+		}
+		double recordSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::vector<std::uint8_t> bytes = recorder.serialize(static_cast<unsigned long long>(options.steps));
+		Replay replay;
+		replay.open(bytes.data(), bytes.size());
+		ReplayPlayer player(replay);
+		start = std::chrono::steady_clock::now();
+		while (player.step())
+		{
+		}
+		double playSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		bool exact = sameState(player.getCore(), core);
+
+		Random random(options.seed);
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < BENCH_SEEKS; i++)
+		{
+			player.seek(random.nextBelow(static_cast<std::uint32_t>(options.steps)));
+		}
+		double seekSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		player.seek(static_cast<unsigned long long>(options.steps));
+		exact = exact && sameState(player.getCore(), core);
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "replay benchmark, policy " << options.policy << ", " << options.steps << " ticks, " << games << " games\n";
+		std::cout << "size         " << bytes.size() << " bytes, " << replay.getHeader().inputCount << " inputs, "
+			<< static_cast<double>(replay.getHeader().inputBytes) / std::max<std::uint32_t>(1, replay.getHeader().inputCount) << " bytes/input\n";
+		std::cout << "record       " << options.steps / recordSeconds << " ticks/sec (policy included)\n";
+		std::cout << "playback     " << options.steps / playSeconds << " ticks/sec\n";
+		std::cout << "seek         " << seekSeconds / BENCH_SEEKS * 1e6 << " us average over " << BENCH_SEEKS << " random ticks\n";
+		std::cout << "bit-exact    " << (exact ? "yes" : "NO") << "\n";
+	}
+
+	// Times snapshot and restore on games grown to several lengths by the policy
+	void benchSnapshot(const Options& options)
+	{
+		const int lengths[] = { STARTING_LENGTH, 25, 50, 100, 200 };
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "snapshot benchmark, policy " << options.policy << ", board " << options.width << "x" << options.height
+			<< ", " << sizeof(GameSnapshot) << " byte snapshot\n";
+
+		for (int target : lengths)
+		{
+			// Play games until one reaches the length, giving up after a while for policies that never get there
+			GameCore core(options.width, options.height, options.seed);
+			std::unique_ptr<Policy> policy = createPolicy(options.policy, options.seed ^ 0x5A5A5A5Au);
+			for (long long tick = 0; core.getLength() < target && tick < options.maxTicks * 10; tick++)
+			{
+				core.step(policy->decide(core));
+				if (core.isGameOver())
+				{
+					core.reset();
+				}
+			}
+			if (core.getLength() < target)
+			{
+				std::cout << "length " << std::setw(4) << target << "  not reached by the policy\n";
+				continue;
+			}
+
+			std::vector<GameSnapshot> snapshots(2);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (int i = 0; i < BENCH_SNAPSHOTS; i++)
+			{
+				core.snapshot(snapshots[i & 1]);
+			}
+			double snapshotSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			start = std::chrono::steady_clock::now();
+			for (int i = 0; i < BENCH_SNAPSHOTS; i++)
+			{
+				core.restore(snapshots[i & 1]);
+			}
+			double restoreSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			std::cout << "length " << std::setw(4) << core.getLength() << "  snapshot " << std::setw(7) << snapshotSeconds / BENCH_SNAPSHOTS * 1e9
+				<< " ns  restore " << std::setw(7) << restoreSeconds / BENCH_SNAPSHOTS * 1e9 << " ns  ("
+				<< BENCH_SNAPSHOTS / snapshotSeconds / 1e6 << "M snapshots/sec)\n";
+		}
+	}
+
+	// Times every decision of the policy and groups them by the length of the snake
+	void benchDecide(const Options& options)
+	{
+		const int bucketStarts[] = { STARTING_LENGTH, 50, 200, 500, 800 };
+		const int buckets = sizeof(bucketStarts) / sizeof(bucketStarts[0]);
+		double seconds[buckets] = {};
+		long long decisions[buckets] = {};
+
+		GameCore core(options.width, options.height, options.seed);
+		std::unique_ptr<Policy> policy = createPolicy(options.policy, options.seed ^ 0x5A5A5A5Au);
+		long long games = 1;
+		for (long long step = 0; step < options.steps; step++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			Direction direction = policy->decide(core);
+			double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			int bucket = buckets - 1;
+			while (bucket > 0 && core.getLength() < bucketStarts[bucket])
+			{
+				bucket--;
+			}
+			seconds[bucket] += elapsed;
+			decisions[bucket]++;
+
+			core.step(direction);
+			if (core.isGameOver())
+			{
+				// The policy starts each game afresh, as SnakeSim does when it plays games
+				core.reset();
+				policy->reset(options.seed ^ static_cast<unsigned int>(games));
+				games++;
+			}
+		}
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "decide benchmark, policy " << options.policy << ", board " << options.width << "x" << options.height
+			<< ", " << options.steps << " decisions over " << games << " games\n";
+		for (int i = 0; i < buckets; i++)
+		{
+			std::cout << "length " << std::setw(4) << bucketStarts[i] << (i + 1 < buckets ? " - " : " +   ");
+			if (i + 1 < buckets)
+			{
+				std::cout << std::setw(4) << bucketStarts[i + 1] - 1;
+			}
+			if (decisions[i] == 0)
+			{
+				std::cout << "  not reached\n";
+				continue;
+			}
+			std::cout << "  " << std::setw(10) << decisions[i] << " decisions  " << std::setw(8) << seconds[i] / decisions[i] * 1e6
+				<< " us  " << std::setw(12) << decisions[i] / seconds[i] << " decisions/sec\n";
+		}
+	}
+
+	// Plays the same moves budget with 1, 2, 4... search threads and reports how the playout rate scales
+	void benchMcts(const Options& options)
+	{
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "mcts benchmark, board " << options.width << "x" << options.height << ", " << options.steps
+			<< " moves, budget " << options.budgetMs << " ms per move\n";
+
+		double singleThreadRate = 0.0;
+		for (int threads = 1; ; threads = std::min(threads * 2, options.threads))
+		{
+			MctsPolicy policy(threads, options.budgetMs / 1000.0, options.seed);
+			GameCore core(options.width, options.height, options.seed);
+			long long playouts = 0;
+			double seconds = 0.0;
+			int bestScore = 0;
+			long long games = 1;
+			for (long long step = 0; step < options.steps; step++)
+			{
+				Direction direction = policy.decide(core);
+				playouts += policy.getLastPlayouts();
+				seconds += policy.getLastSearchSeconds();
+
+				core.step(direction);
+				bestScore = std::max(bestScore, core.getScore());
+				if (core.isGameOver())
+				{
+					core.reset();
+					games++;
+				}
+			}
+
+			double rate = playouts / std::max(seconds, 1e-9);
+			if (threads == 1)
+			{
+				singleThreadRate = rate;
+			}
+			std::cout << "threads " << std::setw(3) << threads << "  " << std::setw(12) << rate << " playouts/sec  "
+				<< std::setw(9) << static_cast<double>(playouts) / options.steps << " playouts/move  "
+				<< std::setw(5) << rate / std::max(singleThreadRate, 1e-9) << "x  best score " << bestScore << " over " << games << " games\n";
+			if (threads == options.threads)
+			{
+				break;
+			}
+		}
+	}
+
+	// Probes the shared table from one thread, storing the position on a miss. Threads start at different points
+	// of the same positions, so they keep running into each other's slots
+	void probeTable(TranspositionTable& table, const std::vector<std::uint64_t>& keys, int worker, int threads)
+	{
+		std::size_t index = keys.size() * static_cast<std::size_t>(worker) / static_cast<std::size_t>(threads);
+		for (long long i = 0; i < BENCH_TABLE_PROBES; i++)
+		{
+			TableEntry entry;
+			if (!table.probe(keys[index], entry))
+			{
+				entry.value = 1.f;
+				entry.visits = 1;
+				entry.depth = static_cast<std::uint8_t>(i & 0xF);
+				entry.move = static_cast<std::uint8_t>(index & 0x3);
+				table.store(keys[index], entry);
+			}
+			index = (index + 1 == keys.size()) ? 0 : index + 1;
+		}
+	}
+
+	// Checks the incremental hash on a policy session, then times the table under contention
+	void benchTable(const Options& options)
+	{
+		GameCore core(options.width, options.height, options.seed);
+		std::unique_ptr<Policy> policy = createPolicy(options.policy, options.seed ^ 0x5A5A5A5Au);
+		std::vector<std::uint64_t> keys;
+		keys.reserve(static_cast<std::size_t>(options.steps));
+		long long mismatches = 0;
+		long long games = 1;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (long long step = 0; step < options.steps; step++)
+		{
+			core.step(policy->decide(core));
+			if (core.isGameOver())
+			{
+				core.reset();
+				policy->reset(options.seed ^ static_cast<unsigned int>(games));
+				games++;
+			}
+			if (core.getHash() != zobristHash(core))
+			{
+				mismatches++;
+			}
+			keys.push_back(core.getHash());
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::sort(keys.begin(), keys.end());
+		long long distinct = std::unique(keys.begin(), keys.end()) - keys.begin();
+		keys.resize(static_cast<std::size_t>(distinct));
+		Random random(options.seed);
+		for (std::size_t i = keys.size(); i > 1; i--)
+		{
+			std::swap(keys[i - 1], keys[random.nextBelow(static_cast<std::uint32_t>(i))]);
+		}
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "ttable benchmark, policy " << options.policy << ", board " << options.width << "x" << options.height
+			<< ", " << options.steps << " ticks over " << games << " games in " << seconds << " s\n";
+		std::cout << "hash check   " << mismatches << " mismatches, " << distinct << " distinct positions\n";
+
+		TranspositionTable table(BENCH_TABLE_BITS);
+		for (int threads = 1; ; threads = std::min(threads * 2, options.threads))
+		{
+			table.clear();
+			table.clearStats();
+			start = std::chrono::steady_clock::now();
+			{
+				ThreadPool pool(threads);
+				for (int worker = 0; worker < threads; worker++)
+				{
+					pool.submit([&table, &keys, worker, threads] { probeTable(table, keys, worker, threads); });
+				}
+				pool.wait();
+			}
+			seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			TableStats stats = table.getStats();
+			std::cout << "threads " << std::setw(3) << threads << "  " << std::setw(8) << stats.probes / seconds / 1e6 << "M probes/sec  hit rate "
+				<< std::setw(6) << 100.0 * stats.hits / stats.probes << "%  " << stats.stores << " stores, " << stats.replacements << " replacements\n";
+			if (threads == options.threads)
+			{
+				break;
+			}
+		}
+	}
+
+	// Plays a replay file to the end, or to the requested tick
+	bool playReplayFile(const Options& options)
+	{
+		Replay replay;
+		if (!replay.open(options.replay))
+		{
+			std::cerr << options.replay << " is not a replay" << std::endl;
+			return false;
+		}
+
+		const ReplayHeader& header = replay.getHeader();
+		ReplayPlayer player(replay);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if (options.seek >= 0)
+		{
+			player.seek(static_cast<unsigned long long>(options.seek));
+		}
+		else
+		{
+			while (player.step())
+			{
+			}
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const GameCore& core = player.getCore();
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << options.replay << ": board " << header.boardWidth << "x" << header.boardHeight << ", seed " << header.seed
+			<< ", " << header.tickCount << " ticks, " << header.inputCount << " inputs\n";
+		std::cout << "tick         " << player.getTick() << " reached in " << seconds * 1e3 << " ms ("
+			<< player.getTick() / std::max(seconds, 1e-9) << " ticks/sec)\n";
+		std::cout << "game         score " << core.getScore() << ", length " << core.getLength() << ", head "
+			<< core.getBody().front().x << "," << core.getBody().front().y << ", food " << core.getFood().x << "," << core.getFood().y << "\n";
+		return true;
+	}
+
+	// Times VecSnakeEnv against a loop of GameCore instances fed the same random actions
+	void benchVecEnv(const Options& options)
+	{
+		int envCount = static_cast<int>(options.games);
+		Random random(options.seed);
+		std::vector<std::uint8_t> actions(static_cast<std::size_t>(envCount) * BENCH_ACTION_STEPS);
+		for (std::uint8_t& action : actions)
+		{
+			action = static_cast<std::uint8_t>(random.nextBelow(Up + 1));
+		}
+
+		std::vector<GameCore> cores;
+		cores.reserve(envCount);
+		for (int env = 0; env < envCount; env++)
+		{
+			cores.emplace_back(options.width, options.height, gameSeed(options.seed, env));
+		}
+		long long coreFood = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (long long step = 0; step < options.steps; step++)
+		{
+			const std::uint8_t* stepActions = &actions[static_cast<std::size_t>(step % BENCH_ACTION_STEPS) * envCount];
+			for (int env = 0; env < envCount; env++)
+			{
+				int events = cores[env].step(static_cast<Direction>(stepActions[env]));
+				coreFood += (events & GameEvent::AteFood) != 0;
+				if (cores[env].isGameOver())
+				{
+					cores[env].reset();
+				}
+			}
+		}
+		double coreSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		VecSnakeEnv env(envCount, options.width, options.height, options.seed);
+		std::vector<float> rewards(envCount);
+		std::vector<std::uint8_t> dones(envCount);
+		long long envFood = 0;
+		start = std::chrono::steady_clock::now();
+		for (long long step = 0; step < options.steps; step++)
+		{
+			env.step(&actions[static_cast<std::size_t>(step % BENCH_ACTION_STEPS) * envCount], rewards.data(), dones.data());
+			for (float reward : rewards)
+			{
+				envFood += reward > 0.f;
+			}
+		}
+		double envSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		double totalSteps = static_cast<double>(envCount) * options.steps;
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "vecenv benchmark, " << envCount << " games x " << options.steps << " steps, board "
+			<< options.width << "x" << options.height << ", AVX2 " << (VecSnakeEnv::usesAvx2() ? "on" : "off") << "\n";
+		std::cout << "GameCore loop   " << totalSteps / coreSeconds << " steps/sec (" << coreFood << " food eaten)\n";
+		std::cout << "VecSnakeEnv     " << totalSteps / envSeconds << " steps/sec (" << envFood << " food eaten)\n";
+		std::cout << "speedup         " << coreSeconds / envSeconds << "x\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+	{
+		return 1;
+	}
+	if (options.games < 1)
+	{
+		std::cerr << "Nothing to simulate" << std::endl;
+		return 1;
+	}
+	if (!options.replay.empty())
+	{
+		return playReplayFile(options) ? 0 : 1;
+	}
+	if (options.bench == "vecenv")
+	{
+		benchVecEnv(options);
+		return 0;
+	}
+	if (options.bench == "replay")
+	{
+		benchReplay(options);
+		return 0;
+	}
+	if (options.bench == "snapshot")
+	{
+		benchSnapshot(options);
+		return 0;
+	}
+	if (options.bench == "decide")
+	{
+		benchDecide(options);
+		return 0;
+	}
+	if (options.bench == "mcts")
+	{
+		benchMcts(options);
+		return 0;
+	}
+	if (options.bench == "ttable")
+	{
+		benchTable(options);
+		return 0;
+	}
+
+	std::vector<GameResult> results(static_cast<std::size_t>(options.games));
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		ThreadPool pool(options.threads);
+		for (long long first = 0; first < options.games; first += GAMES_PER_TASK)
+		{
+			long long last = std::min(options.games, first + GAMES_PER_TASK);
+			pool.submit([&options, &results, first, last] { playGames(options, first, last, results); });
+		}
+		pool.wait();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printReport(options, results, seconds);
+	return 0;
+}
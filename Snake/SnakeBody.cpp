@@ -0,0 +1,155 @@
+#include "SnakeBody.hpp"
+
+#include <cassert>
+#include <cstring>
+
+/*****************************************************************************************************************
+ *										Cell comparison   														 *
+ *****************************************************************************************************************
+ * Input: Two cells																								 *
+ * Output: bool indicating if the cells are the same / different												 *
+ * Description: Generic comparison operators for board cells.													 *
+ ****************************************************************************************************************/
+bool operator==(Cell left, Cell right)
+{
+	return left.x == right.x && left.y == right.y;
+}
+
+bool operator!=(Cell left, Cell right)
+{
+	return !(left == right);
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Creates an empty body. The body is a ring buffer with room for one segment per board cell, so    *
+ * the snake can grow to cover the entire board without ever allocating memory.									 *
+ ****************************************************************************************************************/
+SnakeBody::SnakeBody() : head(0), count(0)
+{
+}
+
+/*****************************************************************************************************************
+ *										clear()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Removes every segment from the body.															 *
+ ****************************************************************************************************************/
+void SnakeBody::clear()
+{
+	head = 0;
+	count = 0;
+}
+
+/*****************************************************************************************************************
+ *										pushFront()   															 *
+ *****************************************************************************************************************
+ * Input: Cell of the new head																					 *
+ * Output: None																									 *
+ * Description: Adds a new head segment. Moving the snake is a pushFront() paired with a popBack(), both O(1)     *
+ ****************************************************************************************************************/
+void SnakeBody::pushFront(Cell cell)
+{
+	assert(count < MAX_BOARD_CELLS);
+	head = (head == 0) ? MAX_BOARD_CELLS - 1 : head - 1;
+	cells[head] = cell;
+	count++;
+}
+
+/*****************************************************************************************************************
+ *										pushBack()   															 *
+ *****************************************************************************************************************
+ * Input: Cell of the new tail																					 *
+ * Output: None																									 *
+ * Description: Adds a new tail segment. Used when laying out the starting body from head to tail.				 *
+ ****************************************************************************************************************/
+void SnakeBody::pushBack(Cell cell)
+{
+	assert(count < MAX_BOARD_CELLS);
+	cells[(head + count) % MAX_BOARD_CELLS] = cell;
+	count++;
+}
+
+/*****************************************************************************************************************
+ *										popBack()   															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: Cell of the removed tail																				 *
+ * Description: Removes the tail segment and returns the cell it occupied so the caller can free it.			 *
+ ****************************************************************************************************************/
+Cell SnakeBody::popBack()
+{
+	assert(count > 0);
+	count--;
+	return cells[(head + count) % MAX_BOARD_CELLS];
+}
+
+/*****************************************************************************************************************
+ *										front() / back()   														 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: Cell of the head / tail																				 *
+ * Description: Generic getters for the two ends of the body. The body must not be empty.						 *
+ ****************************************************************************************************************/
+Cell SnakeBody::front() const
+{
+	return cells[head];
+}
+
+Cell SnakeBody::back() const
+{
+	return cells[(head + count - 1) % MAX_BOARD_CELLS];
+}
+
+/*****************************************************************************************************************
+ *										operator[]   															 *
+ *****************************************************************************************************************
+ * Input: int index of the segment, where 0 is the head															 *
+ * Output: Cell of the segment																					 *
+ * Description: Random access to the segments from head to tail, mainly used when rendering the snake.           *
+ ****************************************************************************************************************/
+Cell SnakeBody::operator[](int index) const
+{
+	return cells[(head + index) % MAX_BOARD_CELLS];
+}
+
+/*****************************************************************************************************************
+ *										size()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: int number of segments in the body																	 *
+ * Description: Generic getter for the number of segments.														 *
+ ****************************************************************************************************************/
+int SnakeBody::size() const
+{
+	return count;
+}
+
+/*****************************************************************************************************************
+ *										copyTo() / assign()														 *
+ *****************************************************************************************************************
+ * Input: Cell array holding room for size() cells / Cell array and the number of cells it holds				 *
+ * Output: int number of cells copied / None																	 *
+ * Description: Copy the body out of and into a plain array, ordered from head to tail. The ring buffer is       *
+ * copied in at most two memcpy calls, so the cost is proportional to the length of the snake rather than the    *
+ * capacity of the buffer. Used to snapshot and restore games.													 *
+ ****************************************************************************************************************/
+int SnakeBody::copyTo(Cell* destination) const
+{
+	int firstPart = (count < MAX_BOARD_CELLS - head) ? count : MAX_BOARD_CELLS - head;
+	std::memcpy(destination, cells + head, firstPart * sizeof(Cell));
+	std::memcpy(destination + firstPart, cells, (count - firstPart) * sizeof(Cell));
+	return count;
+}
+
+void SnakeBody::assign(const Cell* source, int size)
+{
+	assert(size >= 0 && size <= MAX_BOARD_CELLS);
+	std::memcpy(cells, source, size * sizeof(Cell));
+	head = 0;
+	count = size;
+}
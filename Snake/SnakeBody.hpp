@@ -0,0 +1,38 @@
+#ifndef SNAKEBODY_HPP
+#define SNAKEBODY_HPP
+
+#include <cstdint>
+
+#include "OccupancyGrid.hpp"
+
+// A single board cell packed into 4 bytes so a full board snake stays within a few KB
+struct Cell
+{
+	std::uint16_t x;
+	std::uint16_t y;
+};
+
+bool operator==(Cell left, Cell right);
+bool operator!=(Cell left, Cell right);
+
+class SnakeBody
+{
+	public:
+								SnakeBody();
+		void					clear();
+		void					pushFront(Cell cell);
+		void					pushBack(Cell cell);
+		Cell					popBack();
+		Cell					front() const;
+		Cell					back() const;
+		Cell					operator[](int index) const;
+		int						size() const;
+		int						copyTo(Cell* destination) const;
+		void					assign(const Cell* source, int size);
+
+	private:
+		int						head;
+		int						count;
+		Cell					cells[MAX_BOARD_CELLS];
+};
+#endif
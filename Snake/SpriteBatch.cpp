@@ -0,0 +1,80 @@
+#include "SpriteBatch.hpp"
+
+#include "FrameProfiler.hpp"
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: sf::RenderTarget (the window, or a texture when rendering offscreen) and the atlas texture			 *
+ * Output: None																									 *
+ * Description: The sprite batch collects textured quads for everything drawn from the atlas during a frame,	 *
+ * the HUD, the snake and the food, and submits them to the target with a single draw call and a single texture	 *
+ * bind, no matter how many sprites were added. The board does not change and is drawn by the TileMap from a	 *
+ * vertex buffer of its own.																					 *
+ ****************************************************************************************************************/
+SpriteBatch::SpriteBatch(sf::RenderTarget& target, const sf::Texture& atlas) : target(target), atlas(atlas),
+vertices(sf::Quads)
+{
+}
+
+/*****************************************************************************************************************
+ *										clear()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Removes every quad from the batch. The vertex storage keeps its capacity, so rebuilding the      *
+ * batch each frame does not allocate once the snake has reached its longest length.							 *
+ ****************************************************************************************************************/
+void SpriteBatch::clear()
+{
+	vertices.clear();
+}
+
+/*****************************************************************************************************************
+ *										addSprite()   															 *
+ *****************************************************************************************************************
+ * Input: AtlasRegion::ID of the sprite to draw, sf::Vector2f position of its top left corner					 *
+ * Output: None																									 *
+ * Description: Appends one textured quad for the given region of the atlas to the batch, at the region's size.	 *
+ ****************************************************************************************************************/
+void SpriteBatch::addSprite(AtlasRegion::ID id, sf::Vector2f position)
+{
+	const AtlasRect& region = atlasRegions[id];
+	const float left = static_cast<float>(region.left);
+	const float top = static_cast<float>(region.top);
+	const float width = static_cast<float>(region.width);
+	const float height = static_cast<float>(region.height);
+
+	vertices.append(sf::Vertex(position, sf::Vector2f(left, top)));
+	vertices.append(sf::Vertex(sf::Vector2f(position.x + width, position.y), sf::Vector2f(left + width, top)));
+	vertices.append(sf::Vertex(sf::Vector2f(position.x + width, position.y + height), sf::Vector2f(left + width, top + height)));
+	vertices.append(sf::Vertex(sf::Vector2f(position.x, position.y + height), sf::Vector2f(left, top + height)));
+}
+
+/*****************************************************************************************************************
+ *										addQuads()   															 *
+ *****************************************************************************************************************
+ * Input: sf::VertexArray of quads whose texture coordinates point into the atlas								 *
+ * Output: None																									 *
+ * Description: Appends quads that were laid out elsewhere, such as the text of the HUD.						 *
+ ****************************************************************************************************************/
+void SpriteBatch::addQuads(const sf::VertexArray& quads)
+{
+	for (std::size_t i = 0; i < quads.getVertexCount(); i++)
+	{
+		vertices.append(quads[i]);
+	}
+}
+
+/*****************************************************************************************************************
+ *										render()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Draws every quad in the batch with one draw call using the atlas texture.						 *
+ ****************************************************************************************************************/
+void SpriteBatch::render()
+{
+	ScopedTimer timer(Phase::ID::RenderBatch);
+	target.draw(vertices, sf::RenderStates(&atlas));
+}
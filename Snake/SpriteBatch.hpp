@@ -0,0 +1,25 @@
+#ifndef SPRITEBATCH_HPP
+#define SPRITEBATCH_HPP
+
+#include <SFML/Graphics.hpp>
+
+#include "AtlasLayout.hpp"
+
+// Size of the snake and food sprites in the atlas
+#define SPRITE_DIMENSIONS 32
+
+class SpriteBatch
+{
+	public:
+								SpriteBatch(sf::RenderTarget& target, const sf::Texture& atlas);
+		void					clear();
+		void					addSprite(AtlasRegion::ID id, sf::Vector2f position);
+		void					addQuads(const sf::VertexArray& quads);
+		void					render();
+
+	private:
+		sf::RenderTarget&		target;
+		const sf::Texture&		atlas;
+		sf::VertexArray			vertices;
+};
+#endif
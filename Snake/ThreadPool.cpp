@@ -0,0 +1,181 @@
+#include "ThreadPool.hpp"
+
+namespace
+{
+	// Index of the queue owned by the current worker thread, -1 on threads outside of any pool
+	thread_local int workerIndex = -1;
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: int number of worker threads (at least one is created)												 *
+ * Output: None																									 *
+ * Description: Starts the worker threads. Every worker owns a queue; tasks are spread over the queues round     *
+ * robin, and a worker that runs out of tasks steals from the front of the other queues, so uneven tasks still   *
+ * keep every core busy.																						 *
+ ****************************************************************************************************************/
+ThreadPool::ThreadPool(int threadCount) : queued(0), pending(0), nextQueue(0), stopping(false)
+{
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+	}
+	for (int i = 0; i < threadCount; i++)
+	{
+		workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+	}
+}
+
+/*****************************************************************************************************************
+ *										Destructor   															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Finishes every task that was submitted, then stops and joins the worker threads.				 *
+ ****************************************************************************************************************/
+ThreadPool::~ThreadPool()
+{
+	wait();
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wakeUp.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+/*****************************************************************************************************************
+ *										submit()   																 *
+ *****************************************************************************************************************
+ * Input: std::function<void()> task to run																		 *
+ * Output: None																									 *
+ * Description: Queues a task. Tasks submitted from a worker go to that worker's own queue, which keeps related  *
+ * work on the same core; everything else is spread round robin.												 *
+ ****************************************************************************************************************/
+void ThreadPool::submit(std::function<void()> task)
+{
+	int index = workerIndex;
+	if (index < 0 || index >= static_cast<int>(queues.size()))
+	{
+		index = static_cast<int>(nextQueue++ % queues.size());
+	}
+
+	pending++;
+	{
+		std::lock_guard<std::mutex> lock(queues[index]->mutex);
+		queues[index]->tasks.push_back(std::move(task));
+	}
+	queued++;
+
+	// Taking the sleep mutex orders this wake up after any worker that is about to go to sleep
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	wakeUp.notify_one();
+}
+
+/*****************************************************************************************************************
+ *										wait()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Blocks until every submitted task has finished running. Must not be called from a worker.        *
+ ****************************************************************************************************************/
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(sleepMutex);
+	allDone.wait(lock, [this] { return pending == 0; });
+}
+
+/*****************************************************************************************************************
+ *										getThreadCount()   														 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: int number of worker threads																			 *
+ * Description: Generic getter for the number of worker threads.												 *
+ ****************************************************************************************************************/
+int ThreadPool::getThreadCount() const
+{
+	return static_cast<int>(workers.size());
+}
+
+/*****************************************************************************************************************
+ *										popTask()   															 *
+ *****************************************************************************************************************
+ * Input: int index of the worker, std::function<void()>& receiving the task									 *
+ * Output: bool indicating if a task was found																	 *
+ * Description: Takes the newest task from the worker's own queue, or failing that steals the oldest task from   *
+ * one of the other queues.																						 *
+ ****************************************************************************************************************/
+bool ThreadPool::popTask(int index, std::function<void()>& task)
+{
+	{
+		WorkQueue& own = *queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			queued--;
+			return true;
+		}
+	}
+
+	for (std::size_t i = 1; i < queues.size(); i++)
+	{
+		WorkQueue& victim = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*****************************************************************************************************************
+ *										workerLoop()   															 *
+ *****************************************************************************************************************
+ * Input: int index of the worker																				 *
+ * Output: None																									 *
+ * Description: Runs tasks until the pool is destroyed. A worker only sleeps when no queue holds a task.		 *
+ ****************************************************************************************************************/
+void ThreadPool::workerLoop(int index)
+{
+	workerIndex = index;
+
+	while (true)
+	{
+		std::function<void()> task;
+		if (popTask(index, task))
+		{
+			task();
+			if (--pending == 0)
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+				allDone.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wakeUp.wait(lock, [this] { return stopping || queued > 0; });
+		if (stopping && queued == 0)
+		{
+			return;
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own task queue. Idle workers steal from the others
+class ThreadPool
+{
+	public:
+		explicit								ThreadPool(int threadCount);
+												~ThreadPool();
+		void									submit(std::function<void()> task);
+		void									wait();
+		int										getThreadCount() const;
+
+	private:
+		struct WorkQueue
+		{
+			std::mutex							mutex;
+			std::deque<std::function<void()>>	tasks;
+		};
+
+	private:
+		void									workerLoop(int index);
+		bool									popTask(int index, std::function<void()>& task);
+
+	private:
+		std::vector<std::unique_ptr<WorkQueue>>	queues;
+		std::vector<std::thread>				workers;
+		std::atomic<int>						queued;
+		std::atomic<int>						pending;
+		std::atomic<unsigned int>				nextQueue;
+		bool									stopping;
+		std::mutex								sleepMutex;
+		std::condition_variable					wakeUp;
+		std::condition_variable					allDone;
+};
+#endif
@@ -0,0 +1,457 @@
+#include "TileMap.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#include "ResourceHolder.hpp"
+
+namespace
+{
+	// Reads a map or tile set from the asset pack when one is set and holds it, else from the loose file
+	bool readFile(const std::string& filename, std::string& text)
+	{
+		const AssetPack* pack = ResourceHolder::getAssetPack();
+		const PackEntry* entry = pack ? pack->find(filename) : nullptr;
+		if (entry)
+		{
+			const char* bytes = reinterpret_cast<const char*>(pack->getData(*entry));
+			text.assign(bytes, bytes + entry->size);
+			return true;
+		}
+
+		std::ifstream file(filename, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	// Reads the next tag at or after position, without its angle brackets, and moves position past it. The XML
+	// declaration is skipped. Tiled writes no comments, so a '>' always closes a tag
+	bool nextTag(const std::string& text, std::size_t& position, std::string& tag)
+	{
+		while (true)
+		{
+			std::size_t open = text.find('<', position);
+			std::size_t close = (open == std::string::npos) ? std::string::npos : text.find('>', open);
+			if (close == std::string::npos)
+			{
+				return false;
+			}
+			position = close + 1;
+			if (text[open + 1] != '?' && text[open + 1] != '!')
+			{
+				tag = text.substr(open + 1, close - open - 1);
+				return true;
+			}
+		}
+	}
+
+	// "tileset" for <tileset ...>, "/tileset" for </tileset>
+	std::string tagName(const std::string& tag)
+	{
+		std::string name = tag.substr(0, tag.find_first_of(" \t\r\n"));
+		if (name.size() > 1 && name.back() == '/')
+		{
+			name.pop_back();
+		}
+		return name;
+	}
+
+	std::string attribute(const std::string& tag, const std::string& name, const std::string& fallback = "")
+	{
+		std::string key = " " + name + "=\"";
+		std::size_t start = tag.find(key);
+		if (start == std::string::npos)
+		{
+			return fallback;
+		}
+		start += key.size();
+		std::size_t end = tag.find('"', start);
+		return (end == std::string::npos) ? fallback : tag.substr(start, end - start);
+	}
+
+	int intAttribute(const std::string& tag, const std::string& name, int fallback)
+	{
+		std::string value = attribute(tag, name);
+		return value.empty() ? fallback : std::atoi(value.c_str());
+	}
+
+	// The folder of a file, with its trailing slash, which the files it refers to are relative to
+	std::string directoryOf(const std::string& filename)
+	{
+		std::size_t slash = filename.find_last_of("/\\");
+		return (slash == std::string::npos) ? std::string() : filename.substr(0, slash + 1);
+	}
+
+	// Joins a path relative to a folder, resolving the ./ and ../ Tiled writes, so it can be compared to atlasFiles
+	std::string resolvePath(const std::string& directory, const std::string& path)
+	{
+		std::string joined = directory + path;
+		std::vector<std::string> parts;
+		std::size_t start = 0;
+		while (start <= joined.size())
+		{
+			std::size_t end = joined.find_first_of("/\\", start);
+			if (end == std::string::npos)
+			{
+				end = joined.size();
+			}
+			std::string part = joined.substr(start, end - start);
+			if (part == ".." && !parts.empty() && parts.back() != "..")
+			{
+				parts.pop_back();
+			}
+			else if (!part.empty() && part != ".")
+			{
+				parts.push_back(part);
+			}
+			start = end + 1;
+		}
+
+		std::string resolved;
+		for (const std::string& part : parts)
+		{
+			resolved += (resolved.empty() ? "" : "/") + part;
+		}
+		return resolved;
+	}
+}
+
+/*****************************************************************************************************************
+ *										Constructor																 *
+ *****************************************************************************************************************
+ * Input: sf::RenderTarget (the window, or a texture when rendering offscreen) and the atlas texture			 *
+ * Output: None																									 *
+ * Description: The tile map draws the board from the tile set regions of the atlas. It is empty until			 *
+ * loadFromFile() has read a map.																				 *
+ ****************************************************************************************************************/
+TileMap::TileMap(sf::RenderTarget& target, const sf::Texture& atlas) : target(target), atlas(atlas),
+buffer(sf::Quads, sf::VertexBuffer::Static), tileCount(0), width(0), height(0), tileWidth(0), tileHeight(0)
+{
+}
+
+/*****************************************************************************************************************
+ *										loadFromFile()															 *
+ *****************************************************************************************************************
+ * Input: std::string& file name of a Tiled map (.tmx)															 *
+ * Output: bool indicating if the map was read and every tile set it uses lies in the atlas						 *
+ * Description: Reads the map once: its tile sets, inline or from their .tsx files, and its layers, which must	 *
+ * be stored as CSV. The image of every tile set must be one of the atlasFiles, since the board is drawn from	 *
+ * the atlas. Every tile of a visible layer becomes a quad, in the order of the layers, so later layers cover	 *
+ * earlier ones; hidden layers are skipped, for drawing and for walls alike. The quads are uploaded to a static	 *
+ * vertex buffer once and the copy in memory is freed. Where the graphics card has no vertex buffers the quads	 *
+ * stay in memory and are drawn from there.																		 *
+ ****************************************************************************************************************/
+bool TileMap::loadFromFile(const std::string& filename)
+{
+	tileSets.clear();
+	vertices.clear();
+	tileCount = 0;
+	width = 0;
+	height = 0;
+
+	std::string text;
+	if (!readFile(filename, text))
+	{
+		return false;
+	}
+
+	std::string directory = directoryOf(filename);
+	std::size_t position = 0;
+	std::string tag;
+	while (nextTag(text, position, tag))
+	{
+		std::string name = tagName(tag);
+		if (name == "map")
+		{
+			if (attribute(tag, "orientation", "orthogonal") != "orthogonal")
+			{
+				return false;
+			}
+			width = intAttribute(tag, "width", 0);
+			height = intAttribute(tag, "height", 0);
+			tileWidth = intAttribute(tag, "tilewidth", 0);
+			tileHeight = intAttribute(tag, "tileheight", 0);
+			walkable.assign(width * height, true);
+		}
+		else if (name == "tileset")
+		{
+			TileSet tileSet;
+			tileSet.firstId = static_cast<unsigned int>(std::strtoul(attribute(tag, "firstgid", "1").c_str(), nullptr, 10));
+			std::string source = attribute(tag, "source");
+			bool read = false;
+			if (source.empty())
+			{
+				read = readTileSet(text, position, tag, directory, tileSet);
+			}
+			else
+			{
+				std::string tsxFile = resolvePath(directory, source);
+				std::string tsx;
+				std::string tsxTag;
+				std::size_t tsxPosition = 0;
+				read = readFile(tsxFile, tsx) && nextTag(tsx, tsxPosition, tsxTag) && tagName(tsxTag) == "tileset" &&
+					readTileSet(tsx, tsxPosition, tsxTag, directoryOf(tsxFile), tileSet);
+			}
+			if (!read)
+			{
+				return false;
+			}
+			tileSets.push_back(tileSet);
+		}
+		else if (name == "layer")
+		{
+			if (width <= 0 || height <= 0 || !readLayer(text, position, attribute(tag, "visible", "1") != "0"))
+			{
+				return false;
+			}
+		}
+	}
+	if (width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	tileCount = vertices.size() / 4;
+	if (!vertices.empty() && sf::VertexBuffer::isAvailable() && buffer.create(vertices.size()) && buffer.update(vertices.data()))
+	{
+		std::vector<sf::Vertex>().swap(vertices);
+	}
+	return true;
+}
+
+/*****************************************************************************************************************
+ *										readTileSet()															 *
+ *****************************************************************************************************************
+ * Input: std::string& text of the .tmx or .tsx file, position just past the opening tileset tag, which is		 *
+ * passed in, and the folder its image is relative to. TileSet to fill											 *
+ * Output: bool indicating if the tile set has a tile size, columns and an image that lies in the atlas			 *
+ * Description: Reads the tile set up to its closing tag: the image, which decides the atlas region, and the	 *
+ * IDs of the tiles whose walkable property is false.															 *
+ ****************************************************************************************************************/
+bool TileMap::readTileSet(const std::string& text, std::size_t& position, const std::string& tag, const std::string& directory,
+	TileSet& tileSet) const
+{
+	tileSet.tileWidth = intAttribute(tag, "tilewidth", 0);
+	tileSet.tileHeight = intAttribute(tag, "tileheight", 0);
+	tileSet.columns = intAttribute(tag, "columns", 0);
+	tileSet.tileCount = intAttribute(tag, "tilecount", 0);
+	tileSet.region = nullptr;
+	tileSet.blocked.clear();
+
+	// A tile set without an image cannot be drawn from the atlas
+	if (tag.back() == '/')
+	{
+		return false;
+	}
+
+	int tile = -1;
+	std::string inner;
+	while (nextTag(text, position, inner))
+	{
+		std::string name = tagName(inner);
+		if (name == "/tileset")
+		{
+			break;
+		}
+		if (name == "image")
+		{
+			std::string image = resolvePath(directory, attribute(inner, "source"));
+			for (int i = 0; i < AtlasRegion::Count; i++)
+			{
+				if (atlasFiles[i] != nullptr && image == atlasFiles[i])
+				{
+					tileSet.region = &atlasRegions[i];
+				}
+			}
+		}
+		else if (name == "tile")
+		{
+			tile = intAttribute(inner, "id", -1);
+		}
+		else if (name == "/tile")
+		{
+			tile = -1;
+		}
+		else if (name == "property" && tile >= 0 && attribute(inner, "name") == "walkable" && attribute(inner, "value") == "false")
+		{
+			tileSet.blocked.push_back(tile);
+		}
+	}
+	return tileSet.region != nullptr && tileSet.tileWidth > 0 && tileSet.tileHeight > 0 && tileSet.columns > 0;
+}
+
+/*****************************************************************************************************************
+ *										readLayer()																 *
+ *****************************************************************************************************************
+ * Input: std::string& text of the .tmx file, position just past the opening layer tag, bool indicating if the	 *
+ * layer is shown																								 *
+ * Output: bool indicating if the layer holds one CSV tile ID for every cell of the map							 *
+ * Description: Parses the CSV data of the layer in place and adds a tile for every cell that has one. A hidden	 *
+ * layer is only checked and skipped.																			 *
+ ****************************************************************************************************************/
+bool TileMap::readLayer(const std::string& text, std::size_t& position, bool visible)
+{
+	std::string tag;
+	if (!nextTag(text, position, tag) || tagName(tag) != "data" || attribute(tag, "encoding") != "csv")
+	{
+		return false;
+	}
+	std::size_t end = text.find('<', position);
+	if (end == std::string::npos)
+	{
+		return false;
+	}
+
+	const char* cursor = text.c_str() + position;
+	const char* last = text.c_str() + end;
+	for (int cell = 0; cell < width * height; cell++)
+	{
+		char* next = nullptr;
+		unsigned long id = std::strtoul(cursor, &next, 10);
+		if (next == cursor || next > last)
+		{
+			return false;
+		}
+		if (visible)
+		{
+			addTile(cell % width, cell / width, static_cast<unsigned int>(id));
+		}
+		// strtoul skips the line breaks, only the commas are left to step over
+		cursor = next;
+		if (cursor < last && *cursor == ',')
+		{
+			cursor++;
+		}
+	}
+	position = end;
+	return true;
+}
+
+/*****************************************************************************************************************
+ *										addTile()																 *
+ *****************************************************************************************************************
+ * Input: int x and int y of the cell, unsigned int tile ID as Tiled stores it, 0 for none						 *
+ * Output: None																									 *
+ * Description: Appends the quad of a tile, with the texture coordinates of its tile in the atlas, flipped as	 *
+ * Tiled flipped it. A tile larger than the cells of the map stands on the bottom of its cell, as Tiled draws	 *
+ * it. A tile that is not walkable makes its cell a wall.														 *
+ ****************************************************************************************************************/
+void TileMap::addTile(int x, int y, unsigned int id)
+{
+	bool flipHorizontally = (id & TILE_FLIPPED_HORIZONTALLY) != 0;
+	bool flipVertically = (id & TILE_FLIPPED_VERTICALLY) != 0;
+	bool flipDiagonally = (id & TILE_FLIPPED_DIAGONALLY) != 0;
+	id &= ~(TILE_FLIPPED_HORIZONTALLY | TILE_FLIPPED_VERTICALLY | TILE_FLIPPED_DIAGONALLY);
+
+	// Tile sets are in the order of their first IDs, the last one that starts at or before the ID holds the tile
+	const TileSet* tileSet = nullptr;
+	for (const TileSet& candidate : tileSets)
+	{
+		if (candidate.firstId <= id)
+		{
+			tileSet = &candidate;
+		}
+	}
+	if (id == 0 || tileSet == nullptr)
+	{
+		return;
+	}
+	int local = static_cast<int>(id - tileSet->firstId);
+	if (tileSet->tileCount > 0 && local >= tileSet->tileCount)
+	{
+		return;
+	}
+	if (std::find(tileSet->blocked.begin(), tileSet->blocked.end(), local) != tileSet->blocked.end())
+	{
+		walkable[y * width + x] = false;
+	}
+
+	const float size[2] = { static_cast<float>(tileSet->tileWidth), static_cast<float>(tileSet->tileHeight) };
+	const float left = static_cast<float>(tileSet->region->left + (local % tileSet->columns) * tileSet->tileWidth);
+	const float top = static_cast<float>(tileSet->region->top + (local / tileSet->columns) * tileSet->tileHeight);
+	const sf::Vector2f position(static_cast<float>(x * tileWidth), static_cast<float>((y + 1) * tileHeight) - size[1]);
+
+	// Corners clockwise from the top left. Tiled flips diagonally first, then horizontally, then vertically
+	sf::Vector2f corners[4] = { sf::Vector2f(left, top), sf::Vector2f(left + size[0], top), sf::Vector2f(left + size[0], top + size[1]),
+		sf::Vector2f(left, top + size[1]) };
+	if (flipDiagonally)
+	{
+		std::swap(corners[1], corners[3]);
+	}
+	if (flipHorizontally)
+	{
+		std::swap(corners[0], corners[1]);
+		std::swap(corners[2], corners[3]);
+	}
+	if (flipVertically)
+	{
+		std::swap(corners[0], corners[3]);
+		std::swap(corners[1], corners[2]);
+	}
+
+	vertices.push_back(sf::Vertex(position, corners[0]));
+	vertices.push_back(sf::Vertex(sf::Vector2f(position.x + size[0], position.y), corners[1]));
+	vertices.push_back(sf::Vertex(sf::Vector2f(position.x + size[0], position.y + size[1]), corners[2]));
+	vertices.push_back(sf::Vertex(sf::Vector2f(position.x, position.y + size[1]), corners[3]));
+}
+
+/*****************************************************************************************************************
+ *										isWalkable()															 *
+ *****************************************************************************************************************
+ * Input: int x and int y of a cell of the map																	 *
+ * Output: bool indicating if the cell lies on the map and no tile on it is marked walkable=false				 *
+ * Description: Lookup in the walls read from the map.															 *
+ ****************************************************************************************************************/
+bool TileMap::isWalkable(int x, int y) const
+{
+	return x >= 0 && y >= 0 && x < width && y < height && walkable[y * width + x];
+}
+
+/*****************************************************************************************************************
+ *										Getters																	 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: The size of the map in cells / the number of tiles drawn												 *
+ * Description: Generic getter functions.																		 *
+ ****************************************************************************************************************/
+int TileMap::getWidth() const
+{
+	return width;
+}
+
+int TileMap::getHeight() const
+{
+	return height;
+}
+
+std::size_t TileMap::getTileCount() const
+{
+	return tileCount;
+}
+
+/*****************************************************************************************************************
+ *										render()																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Draws the whole board with one draw call using the atlas texture, from the vertex buffer on the	 *
+ * graphics card, so nothing of the board is sent again after loading.											 *
+ ****************************************************************************************************************/
+void TileMap::render()
+{
+	sf::RenderStates states(&atlas);
+	if (buffer.getVertexCount() > 0)
+	{
+		target.draw(buffer, states);
+	}
+	else if (!vertices.empty())
+	{
+		target.draw(vertices.data(), vertices.size(), sf::Quads, states);
+	}
+}
@@ -0,0 +1,61 @@
+#ifndef TILEMAP_HPP
+#define TILEMAP_HPP
+
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "AtlasLayout.hpp"
+
+// Flags Tiled keeps in the top bits of a tile ID for flipped tiles
+#define TILE_FLIPPED_HORIZONTALLY 0x80000000u
+#define TILE_FLIPPED_VERTICALLY 0x40000000u
+#define TILE_FLIPPED_DIAGONALLY 0x20000000u
+
+// The board as drawn in Tiled (Media/Textures/SnakeBoard.tmx). The CSV layers are read once and every tile becomes a
+// quad of one static vertex buffer over the tile set regions of the atlas, so the board costs one draw call a frame
+// and memory in proportion to its tiles, not to its size in pixels. Tiles whose tile set marks them walkable=false
+// are walls of the board
+class TileMap
+{
+	public:
+								TileMap(sf::RenderTarget& target, const sf::Texture& atlas);
+		bool					loadFromFile(const std::string& filename);
+		bool					isWalkable(int x, int y) const;
+		int						getWidth() const;
+		int						getHeight() const;
+		std::size_t				getTileCount() const;
+		void					render();
+
+	private:
+		struct TileSet
+		{
+			unsigned int		firstId;
+			int					tileWidth;
+			int					tileHeight;
+			int					columns;
+			int					tileCount;
+			const AtlasRect*	region;
+			std::vector<int>	blocked;
+		};
+
+		bool					readTileSet(const std::string& text, std::size_t& position, const std::string& tag,
+									const std::string& directory, TileSet& tileSet) const;
+		bool					readLayer(const std::string& text, std::size_t& position, bool visible);
+		void					addTile(int x, int y, unsigned int id);
+
+	private:
+		sf::RenderTarget&		target;
+		const sf::Texture&		atlas;
+		sf::VertexBuffer		buffer;
+		std::vector<sf::Vertex>	vertices;
+		std::vector<TileSet>	tileSets;
+		std::vector<bool>		walkable;
+		std::size_t				tileCount;
+		int						width;
+		int						height;
+		int						tileWidth;
+		int						tileHeight;
+};
+#endif
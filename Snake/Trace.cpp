@@ -0,0 +1,262 @@
+#include "Trace.hpp"
+
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Process id written with every event, there is only one process in the trace
+	const int processId = 1;
+
+	struct TraceEvent
+	{
+		const char*				name;
+		const char*				category;
+		std::uint64_t			start;
+		std::uint64_t			duration;
+		char					type;
+		char					argument[TRACE_ARGUMENT_LENGTH];
+	};
+
+	// Filled by its own thread and emptied by the writer thread. The padding keeps the two indices on separate
+	// cache lines so the threads do not fight over one
+	struct ThreadBuffer
+	{
+		int								threadId;
+		char							padHead[64];
+		std::atomic<std::uint32_t>		head;
+		char							padTail[64];
+		std::atomic<std::uint32_t>		tail;
+		char							padEvents[64];
+		TraceEvent						events[TRACE_BUFFER_EVENTS];
+	};
+
+	struct TraceState
+	{
+		std::mutex									mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>>	buffers;
+		std::ofstream								file;
+		std::uint64_t								origin;
+		bool										firstEvent;
+		bool										stopping;
+		std::thread									writer;
+		std::condition_variable						wakeUp;
+		std::atomic<long long>						dropped;
+	};
+
+	TraceState& traceState()
+	{
+		static TraceState state;
+		return state;
+	}
+
+	thread_local ThreadBuffer* localBuffer = nullptr;
+
+	ThreadBuffer& threadBuffer()
+	{
+		if (!localBuffer)
+		{
+			TraceState& state = traceState();
+			std::lock_guard<std::mutex> lock(state.mutex);
+			std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+			buffer->threadId = static_cast<int>(state.buffers.size()) + 1;
+			buffer->head.store(0);
+			buffer->tail.store(0);
+			localBuffer = buffer.get();
+			state.buffers.push_back(std::move(buffer));
+		}
+		return *localBuffer;
+	}
+
+	void push(char type, const char* name, const char* category, std::uint64_t start, std::uint64_t end, const char* argument)
+	{
+		ThreadBuffer& buffer = threadBuffer();
+		std::uint32_t position = buffer.head.load(std::memory_order_relaxed);
+		if (position - buffer.tail.load(std::memory_order_acquire) >= TRACE_BUFFER_EVENTS)
+		{
+			traceState().dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		TraceEvent& event = buffer.events[position & (TRACE_BUFFER_EVENTS - 1)];
+		event.type = type;
+		event.name = name;
+		event.category = category;
+		event.start = start;
+		event.duration = end - start;
+		int length = 0;
+		for (; argument && argument[length] != '\0' && length < TRACE_ARGUMENT_LENGTH - 1; length++)
+		{
+			event.argument[length] = argument[length];
+		}
+		event.argument[length] = '\0';
+		buffer.head.store(position + 1, std::memory_order_release);
+	}
+
+	void writeEscaped(std::ostream& out, const char* text)
+	{
+		for (; *text != '\0'; text++)
+		{
+			if (*text == '"' || *text == '\\')
+			{
+				out << '\\';
+			}
+			out << *text;
+		}
+	}
+
+	// Caller holds the mutex of the trace state
+	void flushBuffers(TraceState& state)
+	{
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(3);
+		for (const std::unique_ptr<ThreadBuffer>& buffer : state.buffers)
+		{
+			std::uint32_t position = buffer->tail.load(std::memory_order_relaxed);
+			std::uint32_t end = buffer->head.load(std::memory_order_acquire);
+			for (; position != end; position++)
+			{
+				const TraceEvent& event = buffer->events[position & (TRACE_BUFFER_EVENTS - 1)];
+				out << (state.firstEvent ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"" << event.type
+					<< "\",\"pid\":" << processId << ",\"tid\":" << buffer->threadId;
+				if (event.type == 'X')
+				{
+					out << ",\"cat\":\"" << event.category << "\",\"ts\":" << (static_cast<double>(event.start) - state.origin) / 1000.0
+						<< ",\"dur\":" << event.duration / 1000.0;
+				}
+				if (event.argument[0] != '\0')
+				{
+					out << ",\"args\":{\"" << (event.type == 'M' ? "name" : "detail") << "\":\"";
+					writeEscaped(out, event.argument);
+					out << "\"}";
+				}
+				out << '}';
+				state.firstEvent = false;
+			}
+			buffer->tail.store(end, std::memory_order_release);
+		}
+		state.file << out.str();
+	}
+
+	void writerLoop()
+	{
+		TraceState& state = traceState();
+		std::unique_lock<std::mutex> lock(state.mutex);
+		for (;;)
+		{
+			state.wakeUp.wait_for(lock, std::chrono::milliseconds(TRACE_FLUSH_INTERVAL), [&state] { return state.stopping; });
+			flushBuffers(state);
+			if (state.stopping)
+			{
+				break;
+			}
+		}
+	}
+}
+
+std::atomic<bool> Trace::enabled(false);
+
+/*****************************************************************************************************************
+ *										start()																	 *
+ *****************************************************************************************************************
+ * Input: std::string& name of the trace file																	 *
+ * Output: bool indicating if the file was opened and tracing started											 *
+ * Description: Opens the file and starts the writer thread. The file uses the JSON array form of the trace		 *
+ * event format, which the viewers also accept without its closing bracket, so the trace of a game that			 *
+ * crashed can still be opened.																					 *
+ ****************************************************************************************************************/
+bool Trace::start(const std::string& filename)
+{
+	TraceState& state = traceState();
+	if (isEnabled())
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+	state.file.open(filename, std::ios::out | std::ios::trunc);
+	if (!state.file)
+	{
+		return false;
+	}
+	state.file << "[\n";
+
+	// Spans left over from an earlier trace do not belong to this one
+	for (const std::unique_ptr<ThreadBuffer>& buffer : state.buffers)
+	{
+		buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+	}
+	state.origin = now();
+	state.firstEvent = true;
+	state.stopping = false;
+	state.dropped.store(0);
+	state.writer = std::thread(writerLoop);
+	enabled.store(true, std::memory_order_relaxed);
+	return true;
+}
+
+/*****************************************************************************************************************
+ *										stop()																	 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Stops recording, writes the spans still in the buffers and closes the file.						 *
+ ****************************************************************************************************************/
+void Trace::stop()
+{
+	TraceState& state = traceState();
+	if (!isEnabled())
+	{
+		return;
+	}
+	enabled.store(false, std::memory_order_relaxed);
+
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.stopping = true;
+	}
+	state.wakeUp.notify_one();
+	state.writer.join();
+
+	state.file << "\n]\n";
+	state.file.close();
+}
+
+/*****************************************************************************************************************
+ *										complete()																 *
+ *****************************************************************************************************************
+ * Input: name and category of the span, start and end time from now(), optional argument shown with the span	 *
+ * Output: None																									 *
+ * Description: Records a span into the buffer of the calling thread, which is created the first time the		 *
+ * thread records. A full buffer drops the span and counts it rather than waiting for the writer.				 *
+ ****************************************************************************************************************/
+void Trace::complete(const char* name, const char* category, std::uint64_t start, std::uint64_t end, const char* argument)
+{
+	push('X', name, category, start, end, argument);
+}
+
+/*****************************************************************************************************************
+ *										setThreadName()															 *
+ *****************************************************************************************************************
+ * Input: name of the calling thread																			 *
+ * Output: None																									 *
+ * Description: Names the calling thread's row in the viewer. Call it after start().							 *
+ ****************************************************************************************************************/
+void Trace::setThreadName(const char* name)
+{
+	if (isEnabled())
+	{
+		push('M', "thread_name", "", 0, 0, name);
+	}
+}
+
+long long Trace::getDropped()
+{
+	return traceState().dropped.load();
+}
@@ -0,0 +1,75 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Events each thread can hold before the writer thread empties its buffer, a power of two
+#define TRACE_BUFFER_EVENTS 8192
+// Longest argument kept with an event, longer ones are cut
+#define TRACE_ARGUMENT_LENGTH 48
+// Milliseconds between two flushes of the writer thread
+#define TRACE_FLUSH_INTERVAL 50
+
+// Writes spans in the Chrome trace event format, for chrome://tracing or ui.perfetto.dev. Every thread records
+// into a buffer of its own and a writer thread empties the buffers into the file in the background, so recording
+// a span never touches the file or takes a lock. Span names and categories must be string literals
+class Trace
+{
+	public:
+		static bool				start(const std::string& filename);
+		static void				stop();
+		static bool				isEnabled();
+		static std::uint64_t	now();
+		static void				complete(const char* name, const char* category, std::uint64_t start, std::uint64_t end, const char* argument = nullptr);
+		static void				setThreadName(const char* name);
+		static long long		getDropped();
+
+	private:
+								Trace();
+
+	private:
+		static std::atomic<bool>	enabled;
+};
+
+// Records a span from its construction to its destruction while tracing is on
+class TraceSpan
+{
+	public:
+								TraceSpan(const char* name, const char* category, const char* argument = nullptr) : name(name),
+								category(category), argument(argument), start(Trace::isEnabled() ? Trace::now() : 0)
+		{
+		}
+
+								~TraceSpan()
+		{
+			if (start != 0)
+			{
+				Trace::complete(name, category, start, Trace::now(), argument);
+			}
+		}
+
+	private:
+								TraceSpan(const TraceSpan&);
+		TraceSpan&				operator=(const TraceSpan&);
+
+	private:
+		const char*				name;
+		const char*				category;
+		const char*				argument;
+		std::uint64_t			start;
+};
+
+inline bool Trace::isEnabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+// Nanoseconds on the steady clock, the time base of both the trace and the FrameProfiler
+inline std::uint64_t Trace::now()
+{
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+#endif
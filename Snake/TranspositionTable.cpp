@@ -0,0 +1,203 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Deepest search result the table tells apart
+#define MAX_TABLE_DEPTH 63
+
+namespace
+{
+	// Layout of the 64 bit data word: value in bits 0-31, visits in 32-47, depth in 48-53, move in 54-55 and the
+	// generation in 56-63. Depths above MAX_TABLE_DEPTH are stored as MAX_TABLE_DEPTH
+	std::uint64_t pack(const TableEntry& entry, int generation)
+	{
+		std::uint32_t value;
+		std::memcpy(&value, &entry.value, sizeof(value));
+		return value | (static_cast<std::uint64_t>(entry.visits) << 32) | (static_cast<std::uint64_t>(std::min<int>(entry.depth, MAX_TABLE_DEPTH)) << 48) |
+			(static_cast<std::uint64_t>(entry.move & 0x3) << 54) | (static_cast<std::uint64_t>(generation & 0xFF) << 56);
+	}
+
+	void unpack(std::uint64_t data, TableEntry& entry)
+	{
+		std::uint32_t value = static_cast<std::uint32_t>(data);
+		std::memcpy(&entry.value, &value, sizeof(value));
+		entry.visits = static_cast<std::uint16_t>(data >> 32);
+		entry.depth = static_cast<std::uint8_t>((data >> 48) & 0x3F);
+		entry.move = static_cast<std::uint8_t>((data >> 54) & 0x3);
+	}
+
+	int generationOf(std::uint64_t data)
+	{
+		return static_cast<int>(data >> 56);
+	}
+
+	int depthOf(std::uint64_t data)
+	{
+		return static_cast<int>((data >> 48) & 0x3F);
+	}
+
+	// Threads are numbered in the order they first count something, -1 before that
+	std::atomic<int> threadCount(0);
+	thread_local int threadNumber = -1;
+}
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: int sizeBits, the table holds 2^sizeBits entries														 *
+ * Output: None																									 *
+ * Description: A fixed size hash table of search results keyed by Zobrist hash, shared by every search thread  *
+ * without locks. An entry is two 64 bit words, the data and the key XORed with the data. Threads read and		 *
+ * write the words separately, and a reader whose words come from two different writes sees a key that does	 *
+ * not match and treats the probe as a miss, so a torn entry is never returned.									 *
+ ****************************************************************************************************************/
+TranspositionTable::TranspositionTable(int sizeBits) : mask((static_cast<std::size_t>(1) << sizeBits) - 1),
+slots(new Slot[static_cast<std::size_t>(1) << sizeBits]), generation(1)
+{
+	clear();
+	clearStats();
+}
+
+/*****************************************************************************************************************
+ *										probe()																	 *
+ *****************************************************************************************************************
+ * Input: std::uint64_t key of the position, TableEntry& receiving the stored result							 *
+ * Output: bool true on a hit																					 *
+ * Description: Looks the position up in its slot. Counts every probe and every hit in the counters of the		 *
+ * calling thread.																								 *
+ ****************************************************************************************************************/
+bool TranspositionTable::probe(std::uint64_t key, TableEntry& entry)
+{
+	Counters& local = localCounters();
+	local.probes.fetch_add(1, std::memory_order_relaxed);
+	const Slot& slot = slots[key & mask];
+	std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+	std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+	if (data == 0 || (check ^ data) != key)
+	{
+		return false;
+	}
+	unpack(data, entry);
+	local.hits.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+/*****************************************************************************************************************
+ *										store()																	 *
+ *****************************************************************************************************************
+ * Input: std::uint64_t key of the position, TableEntry to remember												 *
+ * Output: None																									 *
+ * Description: Replacement policy: an entry replaces the one in its slot if the slot is empty, holds the same  *
+ * position, was written during an earlier search, or holds a result searched no deeper than the new one. So	 *
+ * deep results survive within a search, and stale ones make way once newSearch() is called.					 *
+ ****************************************************************************************************************/
+void TranspositionTable::store(std::uint64_t key, const TableEntry& entry)
+{
+	Slot& slot = slots[key & mask];
+	int current = generation.load(std::memory_order_relaxed);
+	std::uint64_t old = slot.data.load(std::memory_order_relaxed);
+	bool samePosition = (slot.check.load(std::memory_order_relaxed) ^ old) == key;
+
+	if (old != 0 && !samePosition && generationOf(old) == (current & 0xFF) && depthOf(old) > std::min<int>(entry.depth, MAX_TABLE_DEPTH))
+	{
+		return;
+	}
+	Counters& local = localCounters();
+	if (old != 0 && !samePosition)
+	{
+		local.replacements.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::uint64_t data = pack(entry, current);
+	slot.data.store(data, std::memory_order_relaxed);
+	slot.check.store(key ^ data, std::memory_order_relaxed);
+	local.stores.fetch_add(1, std::memory_order_relaxed);
+}
+
+/*****************************************************************************************************************
+ *										localCounters()															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: The counters of the calling thread																	 *
+ * Description: Every thread counts into a set of counters of its own, so probes from many threads never write	 *
+ * to the same cache line. Threads are numbered as they first count and take the set of their number modulo		 *
+ * TABLE_COUNTER_SLOTS, so threads started together, such as the workers of a pool, share none unless there are	 *
+ * more of them than sets. Sharing costs speed but loses no counts.												 *
+ ****************************************************************************************************************/
+TranspositionTable::Counters& TranspositionTable::localCounters()
+{
+	if (threadNumber < 0)
+	{
+		threadNumber = threadCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	return counters[threadNumber % TABLE_COUNTER_SLOTS];
+}
+
+/*****************************************************************************************************************
+ *										newSearch()																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Starts a new generation. Entries of earlier generations stay readable but may be replaced by	 *
+ * anything.																									 *
+ ****************************************************************************************************************/
+void TranspositionTable::newSearch()
+{
+	int next = generation.load() + 1;
+	// Generation 0 is kept for empty slots, whose data word is 0
+	generation.store((next & 0xFF) == 0 ? next + 1 : next);
+}
+
+/*****************************************************************************************************************
+ *										clear() / clearStats()													 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Empty the table / reset the counters. Neither may run while other threads use the table.		 *
+ ****************************************************************************************************************/
+void TranspositionTable::clear()
+{
+	for (std::size_t i = 0; i <= mask; i++)
+	{
+		slots[i].check.store(0, std::memory_order_relaxed);
+		slots[i].data.store(0, std::memory_order_relaxed);
+	}
+}
+
+void TranspositionTable::clearStats()
+{
+	for (Counters& slot : counters)
+	{
+		slot.probes = 0;
+		slot.hits = 0;
+		slot.stores = 0;
+		slot.replacements = 0;
+	}
+}
+
+/*****************************************************************************************************************
+ *										Getters 																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: The counters or the number of entries																 *
+ * Description: Generic getter functions. The counters are the sums over every thread's counters. The hit rate	 *
+ * is hits / probes.																							 *
+ ****************************************************************************************************************/
+TableStats TranspositionTable::getStats() const
+{
+	TableStats stats = {};
+	for (const Counters& slot : counters)
+	{
+		stats.probes += slot.probes.load();
+		stats.hits += slot.hits.load();
+		stats.stores += slot.stores.load();
+		stats.replacements += slot.replacements.load();
+	}
+	return stats;
+}
+
+std::size_t TranspositionTable::getSize() const
+{
+	return mask + 1;
+}
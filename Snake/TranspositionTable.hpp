@@ -0,0 +1,67 @@
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Size of a cache line, to keep the counters of the table from sharing one
+#define CACHE_LINE_SIZE 64
+// Sets of counters a table keeps, one per thread using it. Threads beyond that share them, which stays correct
+#define TABLE_COUNTER_SLOTS 64
+
+// What a search remembers about a position
+struct TableEntry
+{
+	float					value;
+	std::uint16_t			visits;
+	std::uint8_t			depth;
+	std::uint8_t			move;
+};
+
+struct TableStats
+{
+	long long				probes;
+	long long				hits;
+	long long				stores;
+	long long				replacements;
+};
+
+class TranspositionTable
+{
+	public:
+		explicit				TranspositionTable(int sizeBits);
+		bool					probe(std::uint64_t key, TableEntry& entry);
+		void					store(std::uint64_t key, const TableEntry& entry);
+		void					newSearch();
+		void					clear();
+		TableStats				getStats() const;
+		void					clearStats();
+		std::size_t				getSize() const;
+
+	private:
+		struct Slot
+		{
+			std::atomic<std::uint64_t>	check;
+			std::atomic<std::uint64_t>	data;
+		};
+
+		// The counters of one thread, on a cache line of their own so counting never bounces it between cores
+		struct alignas(CACHE_LINE_SIZE) Counters
+		{
+			std::atomic<long long>		probes;
+			std::atomic<long long>		hits;
+			std::atomic<long long>		stores;
+			std::atomic<long long>		replacements;
+		};
+
+	private:
+		Counters&				localCounters();
+
+	private:
+		std::size_t				mask;
+		std::unique_ptr<Slot[]>	slots;
+		std::atomic<int>		generation;
+		Counters				counters[TABLE_COUNTER_SLOTS];
+};
+#endif
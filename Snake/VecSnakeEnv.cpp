@@ -0,0 +1,393 @@
+#include "VecSnakeEnv.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <immintrin.h>
+	#include <intrin.h>
+	#define VECENV_AVX2_PATH 1
+	#define VECENV_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	#include <immintrin.h>
+	#define VECENV_AVX2_PATH 1
+	#define VECENV_AVX2_TARGET __attribute__((target("avx2")))
+#else
+	#define VECENV_AVX2_PATH 0
+#endif
+
+// Number of games one AVX2 register holds (eight 32 bit lanes)
+#define AVX2_LANES 8
+
+/*****************************************************************************************************************
+ *										Constructor   															 *
+ *****************************************************************************************************************
+ * Input: int number of games, int width and int height of the board in cells, unsigned int seed				 *
+ * Output: None																									 *
+ * Description: VecSnakeEnv steps many independent games in lockstep for reinforcement learning. The games are   *
+ * stored as a structure of arrays (heads, directions, lengths and food cells in contiguous arrays, one          *
+ * occupancy bitboard and one ring buffer of cell indices per game), so a batch streams through memory instead   *
+ * of hopping between GameCore objects. Every array is allocated here once; stepping never allocates. Throws	 *
+ * std::invalid_argument for a board isPlayableBoard() rejects, where the starting snake would be written off	 *
+ * the board.																									 *
+ ****************************************************************************************************************/
+VecSnakeEnv::VecSnakeEnv(int envCount, int boardWidth, int boardHeight, unsigned int seed) : count(envCount), width(boardWidth),
+height(boardHeight), cells(boardWidth * boardHeight), words((boardWidth * boardHeight + 63) / 64)
+{
+	if (!isPlayableBoard(boardWidth, boardHeight))
+	{
+		throw std::invalid_argument("VecSnakeEnv board " + std::to_string(boardWidth) + "x" + std::to_string(boardHeight) + " is not playable");
+	}
+	headX.resize(count);
+	headY.resize(count);
+	direction.resize(count);
+	length.resize(count);
+	food.resize(count);
+	bodyStart.resize(count);
+	occupancy.resize(static_cast<std::size_t>(count) * words);
+	body.resize(static_cast<std::size_t>(count) * cells);
+
+	// Every game draws from its own stream of the same seed, so neighbouring games never share food positions
+	random.reserve(count);
+	for (int env = 0; env < count; env++)
+	{
+		random.push_back(Random(seed, static_cast<std::uint64_t>(env)));
+	}
+	reset();
+}
+
+/*****************************************************************************************************************
+ *										reset()   																 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: None																									 *
+ * Description: Starts a new game on every board.																 *
+ ****************************************************************************************************************/
+void VecSnakeEnv::reset()
+{
+	for (int env = 0; env < count; env++)
+	{
+		resetEnv(env);
+	}
+}
+
+/*****************************************************************************************************************
+ *										resetEnv()   															 *
+ *****************************************************************************************************************
+ * Input: int index of the game																					 *
+ * Output: None																									 *
+ * Description: Mirrors GameCore::reset for one board: the snake returns to STARTING_LENGTH in the center of the *
+ * board facing STARTING_DIRECTION and new food is generated.													 *
+ ****************************************************************************************************************/
+void VecSnakeEnv::resetEnv(int env)
+{
+	std::uint64_t* bits = &occupancy[static_cast<std::size_t>(env) * words];
+	std::uint16_t* ring = &body[static_cast<std::size_t>(env) * cells];
+	std::memset(bits, 0, words * sizeof(std::uint64_t));
+
+	headX[env] = width / 2;
+	headY[env] = height / 2;
+	direction[env] = STARTING_DIRECTION;
+	length[env] = STARTING_LENGTH;
+	bodyStart[env] = 0;
+
+	for (int i = 0; i < STARTING_LENGTH; i++)
+	{
+		int cell = headY[env] * width + headX[env] - i;
+		ring[i] = static_cast<std::uint16_t>(cell);
+		bits[cell >> 6] |= std::uint64_t(1) << (cell & 63);
+	}
+	generateNewFood(env);
+}
+
+/*****************************************************************************************************************
+ *										generateNewFood()   													 *
+ *****************************************************************************************************************
+ * Input: int index of the game																					 *
+ * Output: bool indicating if a free cell was found																 *
+ * Description: Places the food on a random free cell using the game's own generator. Returns false when the	 *
+ * snake covers the entire board. As in GameCore, one random number picks the n-th free cell of the occupancy	 *
+ * bitboard, counted a word at a time, so placing food costs the same at any fill level and the batch keeps no	 *
+ * per game set of free cells next to its bitboards.															 *
+ ****************************************************************************************************************/
+bool VecSnakeEnv::generateNewFood(int env)
+{
+	if (length[env] >= cells)
+	{
+		return false;
+	}
+
+	// The body covers length cells, so the rest are free: pick the n-th of them in board order
+	const std::uint64_t* bits = &occupancy[static_cast<std::size_t>(env) * words];
+	int n = static_cast<int>(random[env].nextBelow(static_cast<std::uint32_t>(cells - length[env])));
+	for (int word = 0; word < words; word++)
+	{
+		std::uint64_t free = ~bits[word];
+		if (cells - word * 64 < 64)
+		{
+			free &= (std::uint64_t(1) << (cells - word * 64)) - 1;
+		}
+		int count = countBits(free);
+		if (n < count)
+		{
+			food[env] = word * 64 + selectBit(free, n);
+			return true;
+		}
+		n -= count;
+	}
+	assert(false);
+	return false;
+}
+
+/*****************************************************************************************************************
+ *										step()   																 *
+ *****************************************************************************************************************
+ * Input: actions (one Direction per game), rewards and dones receiving one value per game						 *
+ * Output: None																									 *
+ * Description: Advances every game by one tick. Turning, moving the head and the wall test are computed eight	 *
+ * games at a time with AVX2 when the processor supports it, with a scalar fallback otherwise; the occupancy	 *
+ * and body updates are then applied per game. A game that dies (reward REWARD_DEATH) or fills the board is		 *
+ * flagged in dones and reset in place, so the next step starts a new game on that board. An action past Up is	 *
+ * a caller bug, asserted in debug builds; release builds keep the current direction for it, as for a turn		 *
+ * back.																										 *
+ ****************************************************************************************************************/
+void VecSnakeEnv::step(const std::uint8_t* actions, float* rewards, std::uint8_t* dones)
+{
+	static const bool avx2 = usesAvx2();
+
+	for (int env = 0; env < count; env++)
+	{
+		assert(actions[env] <= Up);
+	}
+
+	int vectorized = 0;
+	if (avx2)
+	{
+		vectorized = count - (count % AVX2_LANES);
+		stepAvx2(0, vectorized, actions, rewards, dones);
+	}
+	stepScalar(vectorized, count, actions, rewards, dones);
+}
+
+/*****************************************************************************************************************
+ *										stepScalar()   															 *
+ *****************************************************************************************************************
+ * Input: range of games [first, last), actions, rewards and dones												 *
+ * Output: None																									 *
+ * Description: Portable version of the step. Directions are numbered so that opposite directions add up to 3,	 *
+ * which makes the turn back check a single addition. Actions past Up keep the current direction, like turns	 *
+ * back.																										 *
+ ****************************************************************************************************************/
+void VecSnakeEnv::stepScalar(int first, int last, const std::uint8_t* actions, float* rewards, std::uint8_t* dones)
+{
+	for (int env = first; env < last; env++)
+	{
+		int facing = direction[env];
+		int action = actions[env];
+		if (action <= Up && action + facing != Down + Up)
+		{
+			facing = action;
+		}
+
+		int x = headX[env] + (facing == Right) - (facing == Left);
+		int y = headY[env] + (facing == Down) - (facing == Up);
+		bool wall = x < 0 || x >= width || y < 0 || y >= height;
+		finishStep(env, facing, x, y, wall, rewards[env], dones[env]);
+	}
+}
+
+/*****************************************************************************************************************
+ *										stepAvx2()   															 *
+ *****************************************************************************************************************
+ * Input: range of games [first, last) holding a multiple of AVX2_LANES games, actions, rewards and dones		 *
+ * Output: None																									 *
+ * Description: AVX2 version of the turn, move and wall test for eight games per iteration. The compare results	 *
+ * are all ones (-1) for true, so subtracting two compares yields the -1/0/+1 head offset directly. Actions		 *
+ * past Up keep the current direction, like turns back.															 *
+ ****************************************************************************************************************/
+#if VECENV_AVX2_PATH
+VECENV_AVX2_TARGET void VecSnakeEnv::stepAvx2(int first, int last, const std::uint8_t* actions, float* rewards, std::uint8_t* dones)
+{
+	const __m256i opposite = _mm256_set1_epi32(Down + Up);
+	const __m256i down = _mm256_set1_epi32(Down);
+	const __m256i left = _mm256_set1_epi32(Left);
+	const __m256i right = _mm256_set1_epi32(Right);
+	const __m256i up = _mm256_set1_epi32(Up);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i maxX = _mm256_set1_epi32(width - 1);
+	const __m256i maxY = _mm256_set1_epi32(height - 1);
+
+	alignas(32) std::int32_t facing[AVX2_LANES];
+	alignas(32) std::int32_t x[AVX2_LANES];
+	alignas(32) std::int32_t y[AVX2_LANES];
+
+	for (int env = first; env < last; env += AVX2_LANES)
+	{
+		__m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&direction[env]));
+		__m256i action = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(actions + env)));
+		__m256i reverse = _mm256_cmpeq_epi32(_mm256_add_epi32(current, action), opposite);
+		__m256i ignored = _mm256_or_si256(reverse, _mm256_cmpgt_epi32(action, up));
+		__m256i turned = _mm256_blendv_epi8(action, current, ignored);
+
+		__m256i dx = _mm256_sub_epi32(_mm256_cmpeq_epi32(turned, left), _mm256_cmpeq_epi32(turned, right));
+		__m256i dy = _mm256_sub_epi32(_mm256_cmpeq_epi32(turned, up), _mm256_cmpeq_epi32(turned, down));
+		__m256i nextX = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&headX[env])), dx);
+		__m256i nextY = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&headY[env])), dy);
+
+		__m256i wall = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpgt_epi32(nextX, maxX), _mm256_cmpgt_epi32(zero, nextX)),
+			_mm256_or_si256(_mm256_cmpgt_epi32(nextY, maxY), _mm256_cmpgt_epi32(zero, nextY)));
+		int wallMask = _mm256_movemask_ps(_mm256_castsi256_ps(wall));
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(facing), turned);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(x), nextX);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(y), nextY);
+
+		for (int lane = 0; lane < AVX2_LANES; lane++)
+		{
+			finishStep(env + lane, facing[lane], x[lane], y[lane], ((wallMask >> lane) & 1) != 0, rewards[env + lane], dones[env + lane]);
+		}
+	}
+}
+#else
+void VecSnakeEnv::stepAvx2(int first, int last, const std::uint8_t* actions, float* rewards, std::uint8_t* dones)
+{
+	stepScalar(first, last, actions, rewards, dones);
+}
+#endif
+
+/*****************************************************************************************************************
+ *										finishStep()   															 *
+ *****************************************************************************************************************
+ * Input: int index of the game, the new direction, the cell the head moves into and whether it is a wall, the   *
+ * reward and done flag to fill in																				 *
+ * Output: None																									 *
+ * Description: Applies the memory side of a tick to one game, following GameCore::step: the tail is released    *
+ * unless the snake eats, the head is tested against the occupancy bitboard and pushed onto the ring buffer, and *
+ * eating grows the snake and places new food. A finished game is reset in place.								 *
+ ****************************************************************************************************************/
+void VecSnakeEnv::finishStep(int env, int facing, int x, int y, bool wall, float& reward, std::uint8_t& done)
+{
+	direction[env] = facing;
+	reward = 0.f;
+	done = 0;
+
+	if (wall)
+	{
+		reward = REWARD_DEATH;
+		done = 1;
+		resetEnv(env);
+		return;
+	}
+
+	std::uint64_t* bits = &occupancy[static_cast<std::size_t>(env) * words];
+	std::uint16_t* ring = &body[static_cast<std::size_t>(env) * cells];
+	int cell = y * width + x;
+	bool ateFood = (cell == food[env]);
+
+	if (!ateFood)
+	{
+		int tailIndex = bodyStart[env] + length[env] - 1;
+		int tail = ring[(tailIndex >= cells) ? tailIndex - cells : tailIndex];
+		bits[tail >> 6] &= ~(std::uint64_t(1) << (tail & 63));
+	}
+
+	if ((bits[cell >> 6] >> (cell & 63)) & 1)
+	{
+		reward = REWARD_DEATH;
+		done = 1;
+		resetEnv(env);
+		return;
+	}
+
+	bodyStart[env] = (bodyStart[env] == 0) ? cells - 1 : bodyStart[env] - 1;
+	ring[bodyStart[env]] = static_cast<std::uint16_t>(cell);
+	bits[cell >> 6] |= std::uint64_t(1) << (cell & 63);
+	headX[env] = x;
+	headY[env] = y;
+
+	if (ateFood)
+	{
+		length[env]++;
+		reward = REWARD_FOOD;
+		if (!generateNewFood(env))
+		{
+			done = 1;
+			resetEnv(env);
+		}
+	}
+}
+
+/*****************************************************************************************************************
+ *										usesAvx2()   															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: bool indicating if step() takes the AVX2 path														 *
+ * Description: Checks at run time that both the processor and the operating system support AVX2, so a single   *
+ * build runs everywhere and falls back to the scalar path on older machines.									 *
+ ****************************************************************************************************************/
+bool VecSnakeEnv::usesAvx2()
+{
+#if VECENV_AVX2_PATH && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+	{
+		return false;
+	}
+	__cpuid(info, 1);
+	bool osSavesAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+	__cpuidex(info, 7, 0);
+	return osSavesAvx && (info[1] & (1 << 5));
+#elif VECENV_AVX2_PATH
+	return __builtin_cpu_supports("avx2") != 0;
+#else
+	return false;
+#endif
+}
+
+/*****************************************************************************************************************
+ *										Getters 																 *
+ *****************************************************************************************************************
+ * Input: int index of the game (and a cell for isOccupied)														 *
+ * Output: The requested part of the game's state																 *
+ * Description: Generic getter functions used to build observations.											 *
+ ****************************************************************************************************************/
+int VecSnakeEnv::getEnvCount() const
+{
+	return count;
+}
+
+int VecSnakeEnv::getHeadX(int env) const
+{
+	return headX[env];
+}
+
+int VecSnakeEnv::getHeadY(int env) const
+{
+	return headY[env];
+}
+
+int VecSnakeEnv::getLength(int env) const
+{
+	return length[env];
+}
+
+int VecSnakeEnv::getFoodCell(int env) const
+{
+	return food[env];
+}
+
+Direction VecSnakeEnv::getDirection(int env) const
+{
+	return static_cast<Direction>(direction[env]);
+}
+
+bool VecSnakeEnv::isOccupied(int env, int x, int y) const
+{
+	int cell = y * width + x;
+	return ((occupancy[static_cast<std::size_t>(env) * words + (cell >> 6)] >> (cell & 63)) & 1) != 0;
+}
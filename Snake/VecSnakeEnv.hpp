@@ -0,0 +1,52 @@
+#ifndef VECSNAKEENV_HPP
+#define VECSNAKEENV_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "GameCore.hpp"
+#include "Random.hpp"
+
+// Rewards handed out by VecSnakeEnv::step()
+#define REWARD_FOOD 1.0f
+#define REWARD_DEATH -1.0f
+
+class VecSnakeEnv
+{
+	public:
+								VecSnakeEnv(int envCount, int boardWidth, int boardHeight, unsigned int seed);
+		void					reset();
+		void					step(const std::uint8_t* actions, float* rewards, std::uint8_t* dones);
+		int						getEnvCount() const;
+		int						getHeadX(int env) const;
+		int						getHeadY(int env) const;
+		int						getLength(int env) const;
+		int						getFoodCell(int env) const;
+		Direction				getDirection(int env) const;
+		bool					isOccupied(int env, int x, int y) const;
+		static bool				usesAvx2();
+
+	private:
+		void					resetEnv(int env);
+		void					finishStep(int env, int direction, int x, int y, bool wall, float& reward, std::uint8_t& done);
+		bool					generateNewFood(int env);
+		void					stepScalar(int first, int last, const std::uint8_t* actions, float* rewards, std::uint8_t* dones);
+		void					stepAvx2(int first, int last, const std::uint8_t* actions, float* rewards, std::uint8_t* dones);
+
+	private:
+		int							count;
+		int							width;
+		int							height;
+		int							cells;
+		int							words;
+		std::vector<std::int32_t>	headX;
+		std::vector<std::int32_t>	headY;
+		std::vector<std::int32_t>	direction;
+		std::vector<std::int32_t>	length;
+		std::vector<std::int32_t>	food;
+		std::vector<std::int32_t>	bodyStart;
+		std::vector<Random>			random;
+		std::vector<std::uint64_t>	occupancy;
+		std::vector<std::uint16_t>	body;
+};
+#endif
@@ -0,0 +1,73 @@
+#include "Zobrist.hpp"
+#include "GameCore.hpp"
+#include "Random.hpp"
+
+// The keys are the same in every run, so hashes can be compared across processes
+#define ZOBRIST_SEED 0x5A0B215BULL
+
+namespace
+{
+	std::uint64_t nextKey(Random& random)
+	{
+		std::uint64_t high = random.next();
+		return (high << 32) | random.next();
+	}
+
+	ZobristKeys createKeys()
+	{
+		ZobristKeys keys;
+		Random random(ZOBRIST_SEED);
+		for (int cell = 0; cell < MAX_BOARD_CELLS; cell++)
+		{
+			keys.head[cell] = nextKey(random);
+			keys.food[cell] = nextKey(random);
+			for (int direction = 0; direction < 4; direction++)
+			{
+				keys.link[cell][direction] = nextKey(random);
+			}
+		}
+		for (int direction = 0; direction < 4; direction++)
+		{
+			keys.facing[direction] = nextKey(random);
+		}
+		return keys;
+	}
+}
+
+/*****************************************************************************************************************
+ *										zobristKeys()															 *
+ *****************************************************************************************************************
+ * Input: None																									 *
+ * Output: const ZobristKeys& shared by every game																 *
+ * Description: The keys are generated on first use from a fixed seed.											 *
+ ****************************************************************************************************************/
+const ZobristKeys& zobristKeys()
+{
+	static const ZobristKeys keys = createKeys();
+	return keys;
+}
+
+/*****************************************************************************************************************
+ *										zobristHash()															 *
+ *****************************************************************************************************************
+ * Input: GameCore to hash																						 *
+ * Output: std::uint64_t hash of the position																	 *
+ * Description: Hashes a position from scratch, in the length of the snake. The GameCore uses it when a game    *
+ * starts and keeps the hash up to date incrementally from there on; GameCore::getHash() must always equal it.	 *
+ ****************************************************************************************************************/
+std::uint64_t zobristHash(const GameCore& core)
+{
+	const ZobristKeys& keys = zobristKeys();
+	const SnakeBody& body = core.getBody();
+	int width = core.getBoardWidth();
+
+	Cell head = body.front();
+	Cell food = core.getFood();
+	std::uint64_t hash = keys.head[head.y * width + head.x] ^ keys.food[food.y * width + food.x] ^ keys.facing[core.getDirection()];
+	for (int i = 1; i < body.size(); i++)
+	{
+		Cell cell = body[i];
+		hash ^= keys.link[cell.y * width + cell.x][directionBetween(cell, body[i - 1])];
+	}
+	return hash;
+}
@@ -0,0 +1,24 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+
+#include "OccupancyGrid.hpp"
+
+class GameCore;
+
+// Random keys for every feature of a position. The hash of a position is the XOR of the keys of its features: the
+// cell of the head, the link from every other body cell to the segment in front of it, the cell of the food and
+// the direction the snake faces. The links pin down the whole body, tail included, and each move of the snake
+// changes only a handful of features, so the GameCore keeps the hash up to date in O(1) per tick
+struct ZobristKeys
+{
+	std::uint64_t			head[MAX_BOARD_CELLS];
+	std::uint64_t			link[MAX_BOARD_CELLS][4];
+	std::uint64_t			food[MAX_BOARD_CELLS];
+	std::uint64_t			facing[4];
+};
+
+const ZobristKeys&			zobristKeys();
+std::uint64_t				zobristHash(const GameCore& core);
+#endif